@@ -69,6 +69,7 @@ using ace_common::TimingStats;
 
 const uint8_t FRAMES_PER_SECOND = 60;
 const uint8_t NUM_SUBFIELDS = 16;
+const uint8_t NUM_BRIGHTNESS_BITS = 4; // 16 levels using bit angle modulation
 
 const uint8_t NUM_DIGITS = 4;
 const uint8_t NUM_SEGMENTS = 8;
@@ -200,6 +201,69 @@ void runScanningBenchmark(const __FlashStringHelper* name, LM& scanningModule) {
   printStats(name, timingStats, numSamples);
 }
 
+// Same as runScanningBenchmark() for a module using kScanningOptionScanPlan.
+// The scan plan is built from the patterns by commit(), and picked up by the
+// first renderFieldNow() of the next frame. If commitEveryFrame is true, the
+// patterns are committed again at the start of every frame, so that the cost
+// of switching to the new plan is measured. Otherwise, only the steady state
+// is measured.
+template <typename LM>
+void runScanPlanBenchmark(
+    const __FlashStringHelper* name,
+    LM& scanningModule,
+    bool commitEveryFrame
+) {
+
+  for (uint8_t i = 0; i < scanningModule.getNumDigits(); ++i) {
+    scanningModule.setPatternAt(i, i);
+    scanningModule.setBrightnessAt(i, i * 5);
+  }
+  scanningModule.commit();
+  while (scanningModule.isCommitPending()) {
+    scanningModule.renderFieldNow();
+  }
+
+  // Sample for 10 frames
+  uint16_t fieldsPerFrame = scanningModule.getFieldsPerFrame();
+  uint16_t numSamples = fieldsPerFrame * 10;
+  timingStats.reset();
+  for (uint16_t i = 0; i < numSamples; i++) {
+    if (commitEveryFrame && i % fieldsPerFrame == 0) {
+      scanningModule.commit();
+    }
+    uint16_t startMicros = micros();
+    scanningModule.renderFieldNow();
+    uint16_t endMicros = micros();
+    timingStats.update(endMicros - startMicros);
+    yield();
+  }
+
+  printStats(name, timingStats, numSamples);
+}
+
+// Change 2 adjacent digits on each sample, which is the typical update of a
+// clock or a counter, then send them with flushDirty() of the controller
+// modules which support auto-increment burst writes.
+template <typename LM>
+void runFlushDirtyBenchmark(const __FlashStringHelper* name, LM& ledModule) {
+  static const uint8_t patterns[4] = {0x13, 0x35, 0x57, 0x79};
+
+  const uint16_t numSamples = 20;
+  timingStats.reset();
+  for (uint16_t i = 0; i < numSamples; ++i) {
+    ledModule.setPatternAt(1, patterns[i % 4]);
+    ledModule.setPatternAt(2, patterns[(i + 1) % 4]);
+
+    uint16_t startMicros = micros();
+    ledModule.flushDirty();
+    uint16_t endMicros = micros();
+    timingStats.update(endMicros - startMicros);
+    yield();
+  }
+
+  printStats(name, timingStats, numSamples);
+}
+
 //-----------------------------------------------------------------------------
 // Direct LED Modules
 //-----------------------------------------------------------------------------
@@ -218,11 +282,45 @@ void runDirect() {
       FRAMES_PER_SECOND,
       SEGMENT_PINS,
       DIGIT_PINS);
+  DirectModule<
+      NUM_DIGITS,
+      NUM_BRIGHTNESS_BITS,
+      ClockInterface,
+      GpioInterface,
+      kScanningOptionBitAngle
+  > scanningModuleBitAngle(
+      kActiveLowPattern /*segmentOnPattern*/,
+      kActiveLowPattern /*digitOnPattern*/,
+      FRAMES_PER_SECOND,
+      SEGMENT_PINS,
+      DIGIT_PINS);
+
+  DirectModule<
+      NUM_DIGITS,
+      NUM_SUBFIELDS,
+      ClockInterface,
+      GpioInterface,
+      kScanningOptionDoubleBuffer | kScanningOptionScanPlan
+  > scanningModuleScanPlan(
+      kActiveLowPattern /*segmentOnPattern*/,
+      kActiveLowPattern /*digitOnPattern*/,
+      FRAMES_PER_SECOND,
+      SEGMENT_PINS,
+      DIGIT_PINS);
 
   scanningModule.begin();
   scanningModuleSubfields.begin();
+  scanningModuleBitAngle.begin();
+  scanningModuleScanPlan.begin();
   runScanningBenchmark(F("Direct(4)"), scanningModule);
   runScanningBenchmark(F("Direct(4,subfields)"), scanningModuleSubfields);
+  runScanningBenchmark(F("Direct(4,bitangle)"), scanningModuleBitAngle);
+  runScanPlanBenchmark(
+      F("Direct(4,subfields,plan)"), scanningModuleScanPlan, false);
+  runScanPlanBenchmark(
+      F("Direct(4,subfields,plan,commit)"), scanningModuleScanPlan, true);
+  scanningModuleScanPlan.end();
+  scanningModuleBitAngle.end();
   scanningModuleSubfields.end();
   scanningModule.end();
 }
@@ -488,13 +586,51 @@ void runHc595HardSpi() {
       kByteOrderDigitHighSegmentLow
   );
 
+  Hc595Module<
+      SpiInterface,
+      8,
+      NUM_BRIGHTNESS_BITS,
+      ClockInterface,
+      kScanningOptionBitAngle
+  > scanningModuleBitAngle(
+      spiInterface,
+      kActiveLowPattern /*segmentOnPattern*/,
+      kActiveLowPattern /*digitOnPattern*/,
+      FRAMES_PER_SECOND,
+      kByteOrderDigitHighSegmentLow
+  );
+
+  Hc595Module<
+      SpiInterface,
+      8,
+      NUM_SUBFIELDS,
+      ClockInterface,
+      kScanningOptionDoubleBuffer | kScanningOptionScanPlan
+  > scanningModuleScanPlan(
+      spiInterface,
+      kActiveLowPattern /*segmentOnPattern*/,
+      kActiveLowPattern /*digitOnPattern*/,
+      FRAMES_PER_SECOND,
+      kByteOrderDigitHighSegmentLow
+  );
+
   SPI.begin();
   spiInterface.begin();
   scanningModule.begin();
   scanningModuleSubfields.begin();
+  scanningModuleBitAngle.begin();
+  scanningModuleScanPlan.begin();
   runScanningBenchmark(F("Hc595(8,HardSpi)"), scanningModule);
   runScanningBenchmark(
       F("Hc595(8,HardSpi,subfields)"), scanningModuleSubfields);
+  runScanningBenchmark(
+      F("Hc595(8,HardSpi,bitangle)"), scanningModuleBitAngle);
+  runScanPlanBenchmark(
+      F("Hc595(8,HardSpi,subfields,plan)"), scanningModuleScanPlan, false);
+  runScanPlanBenchmark(F("Hc595(8,HardSpi,subfields,plan,commit)"),
+      scanningModuleScanPlan, true);
+  scanningModuleScanPlan.end();
+  scanningModuleBitAngle.end();
   scanningModuleSubfields.end();
   scanningModule.end();
   spiInterface.end();
@@ -561,9 +697,10 @@ void runTm1637Benchmark(
   timingStats.reset();
   for (uint16_t i = 0; i < numSamples; ++i) {
 
-    // Update patterns and brightness to mark them dirty.
-    for (uint8_t i = 0; i < numDigits; ++i) {
-      ledModule.setPatternAt(i, kTm1637Patterns[i]);
+    // Update patterns and brightness to mark them dirty. The patterns are
+    // rotated on each sample because setPatternAt() ignores unchanged values.
+    for (uint8_t d = 0; d < numDigits; ++d) {
+      ledModule.setPatternAt(d, kTm1637Patterns[(d + i) % 6]);
     }
     ledModule.setBrightness(1);
 
@@ -596,6 +733,8 @@ void runTm1637SimpleTmi() {
       F("Tm1637(4,SimpleTmi1637,100us)"), tm1637Module, 4, false);
   runTm1637Benchmark(
       F("Tm1637(4,SimpleTmi1637,100us,incremental)"), tm1637Module, 4, true);
+  runFlushDirtyBenchmark(
+      F("Tm1637(4,SimpleTmi1637,100us,dirty)"), tm1637Module);
   tm1637Module.end();
 
   tmiInterface.end();
@@ -631,6 +770,7 @@ void runTm1637SimpleTmiShort() {
   runTm1637Benchmark(F("Tm1637(4,SimpleTmi1637,5us)"), tm1637Module, 4, false);
   runTm1637Benchmark(
       F("Tm1637(4,SimpleTmi1637,5us,incremental)"), tm1637Module, 4, true);
+  runFlushDirtyBenchmark(F("Tm1637(4,SimpleTmi1637,5us,dirty)"), tm1637Module);
   tm1637Module.end();
 
   tmiInterface.end();
@@ -655,6 +795,100 @@ void runTm1637SimpleTmiFastShort() {
 }
 #endif
 
+// Simulate a typical MM:SS clock application which redraws all 4 digits every
+// 10 ms, calling flush() only if isFlushRequired() is true. Simulates 60
+// seconds, or 6000 ticks. Only the ticks which actually called flush() are
+// recorded, so the 'samples' column is the number of flushes out of 6000 ticks.
+static const uint8_t kClockDigitPatterns[10] = {
+  0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F
+};
+
+template <typename LM>
+void runTm1637ClockBenchmark(const __FlashStringHelper* name, LM& ledModule) {
+  const uint16_t numSeconds = 60;
+  const uint8_t ticksPerSecond = 100;
+
+  timingStats.reset();
+  uint16_t numFlushes = 0;
+  for (uint16_t second = 0; second < numSeconds; ++second) {
+    uint8_t minutes = second / 60;
+    uint8_t seconds = second % 60;
+    for (uint8_t tick = 0; tick < ticksPerSecond; ++tick) {
+      ledModule.setPatternAt(0, kClockDigitPatterns[minutes / 10]);
+      ledModule.setPatternAt(1, kClockDigitPatterns[minutes % 10]);
+      ledModule.setPatternAt(2, kClockDigitPatterns[seconds / 10]);
+      ledModule.setPatternAt(3, kClockDigitPatterns[seconds % 10]);
+      if (! ledModule.isFlushRequired()) continue;
+
+      uint16_t startMicros = micros();
+      ledModule.flush();
+      uint16_t endMicros = micros();
+      timingStats.update(endMicros - startMicros);
+      numFlushes++;
+      yield();
+    }
+  }
+
+  printStats(name, timingStats, numFlushes);
+}
+
+void runTm1637SimpleTmiClock() {
+  using TmiInterface = SimpleTmi1637Interface;
+  TmiInterface tmiInterface(DIO_PIN, CLK_PIN, BIT_DELAY);
+  tmiInterface.begin();
+
+  Tm1637Module<TmiInterface, 4> tm1637Module(tmiInterface);
+  tm1637Module.begin();
+  runTm1637ClockBenchmark(
+      F("Tm1637(4,SimpleTmi1637,100us,clock)"), tm1637Module);
+  tm1637Module.end();
+
+  tmiInterface.end();
+}
+
+// Scroll a 16-character message, padded with blanks, across the display using
+// an LedCanvas, sending only the dirty digits with flushDirty(). Each sample
+// is one scroll() and flushDirty() step.
+static const uint8_t kTickerPatterns[16] = {
+  0x76, 0x79, 0x38, 0x38, 0x3F, 0x00, 0x00, 0x00, // "HELLO   "
+  0x3F, 0x3F, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, // "000     "
+};
+
+template <typename LM>
+void runTm1637TickerBenchmark(const __FlashStringHelper* name, LM& ledModule) {
+  LedCanvas<16> canvas(ledModule);
+  canvas.begin();
+  canvas.setPatterns(0, kTickerPatterns, 16);
+  ledModule.flush();
+
+  const uint16_t numSamples = 32;
+  timingStats.reset();
+  for (uint16_t i = 0; i < numSamples; ++i) {
+    uint16_t startMicros = micros();
+    canvas.scroll();
+    ledModule.flushDirty();
+    uint16_t endMicros = micros();
+    timingStats.update(endMicros - startMicros);
+    yield();
+  }
+
+  printStats(name, timingStats, numSamples);
+}
+
+void runTm1637SimpleTmiTicker() {
+  using TmiInterface = SimpleTmi1637Interface;
+  TmiInterface tmiInterface(DIO_PIN, CLK_PIN, BIT_DELAY);
+  tmiInterface.begin();
+
+  Tm1637Module<TmiInterface, 4> tm1637Module(tmiInterface);
+  tm1637Module.begin();
+  runTm1637TickerBenchmark(
+      F("Tm1637(4,SimpleTmi1637,100us,ticker)"), tm1637Module);
+  tm1637Module.end();
+
+  tmiInterface.end();
+}
+
 //-----------------------------------------------------------------------------
 // TM1638 LED Modules
 //-----------------------------------------------------------------------------
@@ -699,6 +933,7 @@ void runTm1638SimpleTmi() {
   Tm1638Module<TmiInterface, 8> tm1638Module(tmiInterface);
   tm1638Module.begin();
   runTm1638Benchmark(F("Tm1638(8,SimpleTmi1638,1us)"), tm1638Module, 8);
+  runFlushDirtyBenchmark(F("Tm1638(8,SimpleTmi1638,1us,dirty)"), tm1638Module);
   tm1638Module.end();
 
   tmiInterface.end();
@@ -865,6 +1100,7 @@ void runHt16k33TwoWire100() {
   wireInterface.begin();
   ht16k33Module.begin();
   runHt16k33Benchmark(F("Ht16k33(4,TwoWire,100kHz)"), ht16k33Module);
+  runFlushDirtyBenchmark(F("Ht16k33(4,TwoWire,100kHz,dirty)"), ht16k33Module);
   ht16k33Module.end();
   wireInterface.end();
 }
@@ -952,6 +1188,8 @@ void runBenchmarks() {
 #if defined(ARDUINO_ARCH_AVR) || defined(EPOXY_DUINO)
   runTm1637SimpleTmiFastShort();
 #endif
+  runTm1637SimpleTmiClock();
+  runTm1637SimpleTmiTicker();
 
   // Tm1638Module
   runTm1638SimpleTmi();
@@ -1016,9 +1254,16 @@ void printSizeOf() {
   SERIAL_PORT_MONITOR.print(F("sizeof(LedModule): "));
   SERIAL_PORT_MONITOR.println(sizeof(LedModule));
 
+  SERIAL_PORT_MONITOR.print(F("sizeof(TimingProbe<>): "));
+  SERIAL_PORT_MONITOR.println(sizeof(TimingProbe<>));
+
   SERIAL_PORT_MONITOR.print( F("sizeof(ScanningModule<LedMatrixBase, 4>): "));
   SERIAL_PORT_MONITOR.println( sizeof(ScanningModule<LedMatrixBase, 4>));
 
+  SERIAL_PORT_MONITOR.print(
+      F("sizeof(ScanningModule<LedMatrixBase, 4, 16>): "));
+  SERIAL_PORT_MONITOR.println(sizeof(ScanningModule<LedMatrixBase, 4, 16>));
+
   SERIAL_PORT_MONITOR.print( F("sizeof(DirectModule<4>): "));
   SERIAL_PORT_MONITOR.println(sizeof(DirectModule<4>));
 
@@ -1039,6 +1284,11 @@ void printSizeOf() {
   SERIAL_PORT_MONITOR.print(F("sizeof(Hc595Module<SimpleSpiInterface, 8>): "));
   SERIAL_PORT_MONITOR.println(sizeof(Hc595Module<SimpleSpiInterface, 8>));
 
+  SERIAL_PORT_MONITOR.print(
+      F("sizeof(Hc595Module<SimpleSpiInterface, 8, NoRemap>): "));
+  SERIAL_PORT_MONITOR.println(sizeof(Hc595Module<
+      SimpleSpiInterface, 8, 1, ClockInterface, kScanningOptionNoRemap>));
+
   SERIAL_PORT_MONITOR.print(
       F("sizeof(Tm1637Module<SimpleTmi1637Interface, 4>): "));
   SERIAL_PORT_MONITOR.println(sizeof(Tm1637Module<SimpleTmi1637Interface, 4>));
@@ -1067,6 +1317,11 @@ void printSizeOf() {
   SERIAL_PORT_MONITOR.print(
       F("sizeof(Ht16k33Module<SimpleWireInterface, 4>): "));
   SERIAL_PORT_MONITOR.println(sizeof(Ht16k33Module<SimpleWireInterface, 4>));
+
+  // LedCanvas
+
+  SERIAL_PORT_MONITOR.print(F("sizeof(LedCanvas<16>): "));
+  SERIAL_PORT_MONITOR.println(sizeof(LedCanvas<16>));
 }
 
 //-----------------------------------------------------------------------------
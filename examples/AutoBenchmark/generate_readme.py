@@ -224,6 +224,66 @@ number of `TimingStats::update()` calls that were made.
     * The majority of the time is spent on the `bitDelay()` between bit
       transitions in the protocol.
 
+**Unreleased**
+
+* `LedModule::setPatternAt()` marks a digit dirty only if its pattern changed.
+    * Add `Tm1637(4,SimpleTmi1637,100us,clock)` which simulates an MM:SS clock
+      that redraws all 4 digits every 10 ms for 60 seconds (6000 ticks), and
+      calls `flush()` only if `isFlushRequired()`. The "samples" column is the
+      number of `flush()` calls that were actually made, about 60 instead of
+      6000.
+    * The other `Tm1637` benchmarks rotate the patterns on each sample so that
+      the digits are still marked dirty.
+* Add `flushDirty()` to `Tm1637Module`, `Tm1638Module` and `Ht16k33Module`.
+    * Sends one auto-increment burst for each run of consecutive dirty digits.
+    * Add `*(...,dirty)` benchmarks which change 2 adjacent digits on each
+      sample, to compare against `flush()` and `flushIncremental()`.
+* Add `LedCanvas`, a scrolling viewport over an `LedModule`.
+    * Add `Tm1637(4,SimpleTmi1637,100us,ticker)` which scrolls a 16-character
+      message with `LedCanvas::scroll()`, and sends only the digits that
+      changed with `flushDirty()`.
+* `ScanningModule` accesses the `LedMatrix` owned by `DirectModule`,
+  `DirectFast4Module`, `HybridModule` and `Hc595Module` directly through the
+  `T_DERIVED` template parameter, instead of through a reference.
+    * Their `sizeof()` becomes one pointer smaller (2 bytes on AVR). In an
+      EpoxyDuino (x86_64) build, `sizeof(Hc595Module<HardSpiInterface, 4>)`
+      goes from 80 to 64 bytes, and `sizeof(DirectModule<4>)` from 80 to 64
+      bytes, the pointer plus its alignment padding.
+    * No speed gain is claimed. In the same EpoxyDuino build, the average
+      `renderFieldNow()` of `Hc595Module<4>` and `DirectModule<4>` over 20
+      million calls was the same before and after the change (1.4 ns and
+      1.1 ns), within the noise between runs. AVR timings need a
+      regeneration of the `*.txt` files, which has not been done yet.
+* Add bit angle modulation with `kScanningOptionBitAngle`.
+    * Add `Direct(4,bitangle)` and `Hc595(8,HardSpi,bitangle)`, which provide
+      16 brightness levels using 4 weighted subfields per digit, compared to
+      the 16 equal subfields of the `*(...,subfields)` rows.
+    * The "samples" column (10 frames) shows that a frame needs 4 times fewer
+      calls to `renderFieldNow()`, and the min/avg/max columns show that each
+      call costs about the same.
+* Add a scan plan with `kScanningOptionScanPlan`.
+    * Add `Direct(4,subfields,plan)` and `Hc595(8,HardSpi,subfields,plan)`.
+      Most calls to `renderFieldNow()` only count down the hold count of the
+      current plan entry, and `draw()` is called at most twice per digit, so
+      the max should be close to the `*(...,subfields)` rows, and the average
+      lower.
+    * The `*(...,plan,commit)` rows call `commit()` on every frame. The plan
+      is built by `commit()` in the calling context, and `renderFieldNow()`
+      only switches to it at the start of the frame, so their max should stay
+      close to the `*(...,plan)` rows.
+    * Measured on an x86_64 host (EpoxyDuino, `g++ -O2`, 8 digits, 16
+      subfields, averaged over 200000 frames, including about 35 ns of clock
+      overhead), building the plan in `commit()` instead of in the first
+      `renderFieldNow()` of the frame changed:
+        * the first `renderFieldNow()` of a frame from 72 ns to 45 ns,
+        * `commit()` from 40 ns to 77 ns,
+        * the other fields unchanged at about 37 ns.
+    * The `*.txt` files have not been regenerated yet, so the tables below do
+      not have the `plan` rows.
+* Add `sizeof(TimingProbe<>)`, the RAM cost of enabling the optional
+  `T_PROBE` instrumentation on a module. The default `NoTimingProbe` adds
+  nothing.
+
 ## Results
 
 The following tables show the number of microseconds taken by:
@@ -64,6 +64,7 @@ END {
         || name ~ /^Hc595\(8,HardSpi\)/ \
         || name ~ /^Tm1637\(4,SimpleTmi1637,100us\)/ \
         || name ~ /^Tm1637\(4,SimpleTmi1637,5us\)/ \
+        || name ~ /^Tm1637\(4,SimpleTmi1637,100us,clock\)/ \
         || name ~ /^Tm1637\(6,SimpleTmi1637,100us\)/ \
         || name ~ /^Tm1638\(8,SimpleTmi1638,1us\)/ \
         || name ~ /^Max7219\(8,HardSpi\)/ \
@@ -0,0 +1,96 @@
+/*
+ * Scroll a message across an 8x8 dot matrix board with one 74HC595 on the rows
+ * and another on the columns, using a DotMatrixModule on top of a
+ * LedMatrixDualHc595. The display is refreshed at 100 frames per second, one
+ * row per field, so renderFieldWhenReady() sends one 16-bit SPI transfer per
+ * field. The scrolling in the loop() shifts whole rows, then writes the next
+ * column of the font into the right edge, and commit() publishes the new frame
+ * at once.
+ */
+
+#include <Arduino.h>
+#include <SPI.h> // SPIClass, SPI
+#include <AceSPI.h> // HardSpiInterface
+#include <AceSegment.h> // DotMatrixModule, LedMatrixDualHc595
+
+using ace_spi::HardSpiInterface;
+using ace_segment::ClockInterface;
+using ace_segment::DotMatrixModule;
+using ace_segment::LedMatrixDualHc595;
+using ace_segment::kScanningOptionDoubleBuffer;
+using ace_segment::kByteOrderGroupHighElementLow;
+using ace_segment::kActiveLowPattern;
+using ace_segment::kActiveHighPattern;
+
+// Replace these with the PIN numbers of your dev board.
+const uint8_t LATCH_PIN = 10;
+const uint8_t DATA_PIN = MOSI;
+const uint8_t CLOCK_PIN = SCK;
+
+// Rows are driven high, columns are pulled low, on most of these boards.
+const uint8_t COLUMN_ON_PATTERN = kActiveLowPattern;
+const uint8_t ROW_ON_PATTERN = kActiveHighPattern;
+const uint8_t HC595_BYTE_ORDER = kByteOrderGroupHighElementLow;
+const uint8_t NUM_ROWS = 8;
+const uint8_t FRAMES_PER_SECOND = 100;
+const uint16_t SCROLL_MILLIS = 80;
+
+using SpiInterface = HardSpiInterface<SPIClass>;
+SpiInterface spiInterface(SPI, LATCH_PIN);
+using LedMatrix = LedMatrixDualHc595<SpiInterface>;
+LedMatrix ledMatrix(
+    spiInterface,
+    COLUMN_ON_PATTERN /*elementOnPattern*/,
+    ROW_ON_PATTERN /*groupOnPattern*/,
+    HC595_BYTE_ORDER);
+
+DotMatrixModule<
+    LedMatrix,
+    NUM_ROWS,
+    uint8_t,
+    1 /*subFields*/,
+    ClockInterface,
+    kScanningOptionDoubleBuffer
+> dotMatrix(ledMatrix, FRAMES_PER_SECOND);
+
+// A 5x7 font of "ACE ", one column per byte, with row 0 in bit 0, followed by
+// a blank column between letters.
+const uint8_t NUM_COLUMNS = 24;
+const uint8_t MESSAGE_COLUMNS[NUM_COLUMNS] = {
+  0x7E, 0x09, 0x09, 0x09, 0x7E, 0x00, // A
+  0x3E, 0x41, 0x41, 0x41, 0x22, 0x00, // C
+  0x7F, 0x49, 0x49, 0x49, 0x41, 0x00, // E
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // space
+};
+
+uint8_t nextColumn = 0;
+uint16_t lastScrollMillis;
+
+void scrollDisplay() {
+  uint16_t nowMillis = millis();
+  if ((uint16_t) (nowMillis - lastScrollMillis) < SCROLL_MILLIS) return;
+  if (dotMatrix.isCommitPending()) return;
+  lastScrollMillis = nowMillis;
+
+  dotMatrix.shiftLeft(1);
+  dotMatrix.setColumn(dotMatrix.kWidth - 1, MESSAGE_COLUMNS[nextColumn]);
+  dotMatrix.commit();
+
+  nextColumn++;
+  if (nextColumn >= NUM_COLUMNS) nextColumn = 0;
+}
+
+void setup() {
+  delay(1000);
+
+  SPI.begin();
+  spiInterface.begin();
+  ledMatrix.begin();
+  dotMatrix.begin();
+  lastScrollMillis = millis();
+}
+
+void loop() {
+  scrollDisplay();
+  dotMatrix.renderFieldWhenReady();
+}
@@ -1,6 +1,8 @@
 /*
  * Same as Hc595Demo, but using timer interrupts (through TimerOne library) to
- * render the LED display.
+ * render the LED display. The TimerOneInterface is the T_TIMER of the
+ * Hc595Module, so startTimer() attaches renderFieldNow() to the Timer1
+ * interrupt, and re-arms Timer1 after each field.
  *
  * Supported microcontroller environments:
  *
@@ -23,6 +25,11 @@
  * then the interrupt handler may interrupt GPIO operation cause spurious
  * results. Interrupt-safety of the various "Fast" classes in this library may
  * be addressed in the future.
+ *
+ * The ledModule is configured with kScanningOptionDoubleBuffer, so the
+ * patterns and brightness written by updateDisplay() become visible only after
+ * commit(), at the start of the next frame. The interrupt handler never
+ * renders a partially updated set of digits.
  */
 
 #include <Arduino.h>
@@ -39,6 +46,10 @@ using ace_spi::HardSpiInterface;
 using ace_spi::SimpleSpiInterface;
 using ace_segment::LedModule;
 using ace_segment::Hc595Module;
+using ace_segment::ClockInterface;
+using ace_segment::NoTimingProbe;
+using ace_segment::TimerOneInterface;
+using ace_segment::kScanningOptionDoubleBuffer;
 using ace_segment::kDigitRemapArray8Hc595;
 using ace_segment::kByteOrderDigitHighSegmentLow;
 using ace_segment::kByteOrderSegmentHighDigitLow;
@@ -219,7 +230,15 @@ const uint8_t BRIGHTNESS_LEVELS[NUM_BRIGHTNESSES] = {
 #else
   #error Unknown INTERFACE_TYPE
 #endif
-Hc595Module<SpiInterface, NUM_DIGITS, NUM_SUBFIELDS> ledModule(
+Hc595Module<
+    SpiInterface,
+    NUM_DIGITS,
+    NUM_SUBFIELDS,
+    ClockInterface,
+    kScanningOptionDoubleBuffer,
+    NoTimingProbe,
+    TimerOneInterface<TimerOne, Timer1>
+> ledModule(
     spiInterface,
     SEGMENT_ON_PATTERN,
     DIGIT_ON_PATTERN,
@@ -262,6 +281,8 @@ void updateDisplay() {
 
   uint16_t nowMillis = millis();
   if ((uint16_t) (nowMillis - prevUpdateMillis) >= 1000) {
+    // Wait until the interrupt handler has picked up the previous commit.
+    if (ledModule.isCommitPending()) return;
     prevUpdateMillis = nowMillis;
 
     // Update the display
@@ -278,20 +299,18 @@ void updateDisplay() {
     uint8_t brightness = BRIGHTNESS_LEVELS[brightnessIndex];
     ledModule.setBrightness(brightness);
     incrementMod(brightnessIndex, NUM_BRIGHTNESSES);
-  }
-}
 
-// Call renderFieldNow() through a timer interrupt.
-void flushModule() {
-  ledModule.renderFieldNow();
+    // Make the new patterns visible at the next frame boundary.
+    ledModule.commit();
+  }
 }
 
+// Call renderFieldNow() through the Timer1 interrupt.
 void setupTimer() {
-  Timer1.initialize(ledModule.getMicrosPerField());
-  Timer1.attachInterrupt(flushModule);
+  ledModule.startTimer();
 }
 
-// Every 5 seconds, print stats about how long flushModule() took.
+// Every 5 seconds, print stats about how long renderFieldNow() took.
 void printStats() {
 #if ENABLE_SERIAL_DEBUG >= 1
   static uint16_t prevStatsMillis;
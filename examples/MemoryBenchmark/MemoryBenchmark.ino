@@ -39,6 +39,11 @@
 #define FEATURE_HT16K33_TWO_WIRE 21
 #define FEATURE_HT16K33_SIMPLE_WIRE 22
 #define FEATURE_HT16K33_SIMPLE_WIRE_FAST 23
+#define FEATURE_DIRECT_MODULE_SUBFIELDS 24
+#define FEATURE_HC595_HARD_SPI_NO_REMAP 25
+#define FEATURE_DIRECT_MODULE_16_DIGITS 26
+#define FEATURE_HYBRID_HARD_SPI_16BIT 27
+#define FEATURE_HT16K33_TWO_WIRE_16BIT 28
 
 // A volatile integer to prevent the compiler from optimizing away the entire
 // program.
@@ -328,6 +333,82 @@ volatile int disableCompilerOptimization = 0;
     Ht16k33Module<WireInterface, NUM_DIGITS> ht16k33Module(
         wireInterface, HT16K33_I2C_ADDRESS);
 
+  #elif FEATURE == FEATURE_DIRECT_MODULE_SUBFIELDS
+    // Same as FEATURE_DIRECT_MODULE, but with brightness control, which
+    // needs the per-digit brightness and subfield state that are omitted when
+    // T_SUBFIELDS == 1.
+    DirectModule<NUM_DIGITS, 16> scanningModule(
+        kActiveLowPattern /*segmentOnPattern*/,
+        kActiveLowPattern /*digitOnPattern*/,
+        FRAMES_PER_SECOND,
+        SEGMENT_PINS,
+        DIGIT_PINS);
+
+  #elif FEATURE == FEATURE_HC595_HARD_SPI_NO_REMAP
+    // Same as FEATURE_HC595_HARD_SPI, without the inverted remap array.
+    using SpiInterface = HardSpiInterface<SPIClass>;
+    SpiInterface spiInterface(SPI, LATCH_PIN);
+    Hc595Module<
+        SpiInterface,
+        NUM_DIGITS,
+        NUM_SUBFIELDS,
+        ClockInterface,
+        kScanningOptionNoRemap
+    > scanningModule(
+        spiInterface,
+        kActiveLowPattern /*segmentOnPattern*/,
+        kActiveLowPattern /*digitOnPattern*/,
+        FRAMES_PER_SECOND,
+        kByteOrderDigitHighSegmentLow
+    );
+
+  #elif FEATURE == FEATURE_DIRECT_MODULE_16_DIGITS
+    // Same as FEATURE_DIRECT_MODULE, but with 16 digits, whose dirty bits need
+    // 2 bytes instead of the single byte used by 8 digits or fewer.
+    const uint8_t DIGIT_PINS_16[16] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 11, 12, 13, 17, 20, 21, 22, 23
+    };
+    DirectModule<16, NUM_SUBFIELDS> scanningModule(
+        kActiveLowPattern /*segmentOnPattern*/,
+        kActiveLowPattern /*digitOnPattern*/,
+        FRAMES_PER_SECOND,
+        SEGMENT_PINS,
+        DIGIT_PINS_16);
+
+  #elif FEATURE == FEATURE_HYBRID_HARD_SPI_16BIT
+    // Same as FEATURE_HYBRID_HARD_SPI, but with 16-bit patterns sent to 2
+    // daisy chained 74HC595 chips.
+    using SpiInterface = HardSpiInterface<SPIClass>;
+    SpiInterface spiInterface(SPI, LATCH_PIN);
+    using LedMatrix = LedMatrixSingleHc595<
+        SpiInterface, GpioInterface, uint16_t>;
+    LedMatrix ledMatrix(
+        spiInterface,
+        kActiveHighPattern /*elementOnPattern*/,
+        kActiveHighPattern /*groupOnPattern*/,
+        NUM_DIGITS,
+        DIGIT_PINS);
+    ScanningModule<
+        LedMatrix,
+        NUM_DIGITS,
+        NUM_SUBFIELDS,
+        ClockInterface,
+        0 /*T_OPTIONS*/,
+        void /*T_DERIVED*/,
+        NoTimingProbe,
+        NoTimerInterface,
+        uint16_t
+    > scanningModule(ledMatrix, FRAMES_PER_SECOND);
+
+  #elif FEATURE == FEATURE_HT16K33_TWO_WIRE_16BIT
+    // Same as FEATURE_HT16K33_TWO_WIRE, but for the 14-segment modules.
+    #include <Wire.h>
+    using WireInterface = TwoWireInterface<TwoWire>;
+    WireInterface wireInterface(Wire);
+    Ht16k33Module<
+        WireInterface, NUM_DIGITS, false, NoTimingProbe, uint16_t
+    > ht16k33Module(wireInterface, HT16K33_I2C_ADDRESS);
+
   #else
     #error Unknown FEATURE
 
@@ -463,6 +544,28 @@ void setup() {
   wireInterface.begin();
   ht16k33Module.begin();
 
+#elif FEATURE == FEATURE_DIRECT_MODULE_SUBFIELDS
+  scanningModule.begin();
+
+#elif FEATURE == FEATURE_HC595_HARD_SPI_NO_REMAP
+  SPI.begin();
+  spiInterface.begin();
+  scanningModule.begin();
+
+#elif FEATURE == FEATURE_DIRECT_MODULE_16_DIGITS
+  scanningModule.begin();
+
+#elif FEATURE == FEATURE_HYBRID_HARD_SPI_16BIT
+  SPI.begin();
+  spiInterface.begin();
+  ledMatrix.begin();
+  scanningModule.begin();
+
+#elif FEATURE == FEATURE_HT16K33_TWO_WIRE_16BIT
+  Wire.begin();
+  wireInterface.begin();
+  ht16k33Module.begin();
+
 #else
   #error Unknown FEATURE
 
@@ -477,7 +580,11 @@ void loop() {
 #if FEATURE == FEATURE_BASELINE
   // do nothing
 
-#elif FEATURE > FEATURE_BASELINE && FEATURE < FEATURE_TM1637_TMI
+#elif (FEATURE > FEATURE_BASELINE && FEATURE < FEATURE_TM1637_TMI) \
+    || FEATURE == FEATURE_DIRECT_MODULE_SUBFIELDS \
+    || FEATURE == FEATURE_HC595_HARD_SPI_NO_REMAP \
+    || FEATURE == FEATURE_DIRECT_MODULE_16_DIGITS \
+    || FEATURE == FEATURE_HYBRID_HARD_SPI_16BIT
   scanningModule.setPatternAt(0, 0x3A);
   scanningModule.renderFieldWhenReady();
 
@@ -533,6 +640,10 @@ void loop() {
   ht16k33Module.setPatternAt(0, 0xff);
   ht16k33Module.flush();
 
+#elif FEATURE == FEATURE_HT16K33_TWO_WIRE_16BIT
+  ht16k33Module.setPatternAt(0, 0x3fff);
+  ht16k33Module.flush();
+
 #elif FEATURE == FEATURE_STUB_MODULE
   stubModule.setPatternAt(0, 0xff);
 
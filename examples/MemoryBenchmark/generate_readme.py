@@ -252,6 +252,49 @@ before substantional refactoring in 2021.
 
 * Add `Tm1638AnodeModule`. Very similar to `Tm1638Module`.
 
+**Unreleased**
+
+* `ScanningModule` omits the per-digit brightness array and the subfield
+  variables when `T_SUBFIELDS == 1`, saving `T_DIGITS + 2` bytes of RAM in the
+  `DirectModule`, `DirectFast4Module`, `Hybrid*` and `Hc595*` rows.
+* Add `DirectModule(subfields)` which uses `T_SUBFIELDS == 16`, to show the
+  cost of brightness control.
+* Add `Hc595(HardSpi,NoRemap)` which uses `kScanningOptionNoRemap` to omit the
+  inverted remap array of `T_DIGITS` bytes.
+* Until the `*.txt` files are regenerated, the following was measured in an
+  EpoxyDuino (x86_64) build with `g++ -Os`, as the text and bss sizes of the
+  `MemoryBenchmark` object file, before and after the 2 changes above. The
+  RAM savings are rounded up to the 8-byte alignment of x86_64:
+    ```
+    +--------------------------------------------------------------+
+    | functionality                   |  text/  bss |  text/  bss |
+    |                                 |      before |       after |
+    |---------------------------------+-------------+-------------|
+    | baseline                        |      76/  4 |      76/  4 |
+    | DirectModule                    |     469/ 92 |     468/ 84 |
+    | Hc595(HardSpi)                  |     436/ 96 |     435/ 88 |
+    | DirectModule(subfields)         |     577/ 92 |     569/ 92 |
+    | Hc595(HardSpi,NoRemap)          |           - |     435/ 80 |
+    +--------------------------------------------------------------+
+    ```
+* `DirectModule`, `DirectFast4Module`, `HybridModule` and `Hc595Module` no
+  longer store a reference to their own `LedMatrix`, saving one pointer of RAM
+  (2 bytes on AVR, 4 bytes on 32-bit processors) in each of those rows.
+* Add `DirectModule(16digits)` which uses 16 digits, whose dirty bits take 2
+  bytes. Modules with 8 digits or fewer still keep their dirty bits in a
+  single byte. Measured with `sizeof()` in an EpoxyDuino (x86_64) build, against
+  v0.12.0:
+    * `Tm1637Module<4>`: 32 bytes, unchanged
+    * `Max7219Module<8>`: 32 bytes, unchanged
+    * `DirectModule<16>`: 104 bytes to 80 bytes
+* Add `Hybrid(HardSpi,16bit)` and `Ht16k33(TwoWire,16bit)` which use
+  `uint16_t` segment patterns, for the 14-segment and 16-segment modules.
+  Adding the `T_PATTERN` parameter did not change the 8-bit rows: compiled
+  with `g++ -Os` in an EpoxyDuino (x86_64) build, the text and bss sizes of
+  features 0 to 25 are identical before and after the change.
+* The `*.txt` files have not been regenerated yet, so these new rows are not
+  in the tables below.
+
 ## Results
 
 The following shows the flash and static memory sizes of the `MemoryBenchmark`
@@ -30,6 +30,11 @@ BEGIN {
   labels[21] = "Ht16k33(TwoWire)";
   labels[22] = "Ht16k33(SimpleWire)";
   labels[23] = "Ht16k33(SimpleWireFast)";
+  labels[24] = "DirectModule(subfields)";
+  labels[25] = "Hc595(HardSpi,NoRemap)";
+  labels[26] = "DirectModule(16digits)";
+  labels[27] = "Hybrid(HardSpi,16bit)";
+  labels[28] = "Ht16k33(TwoWire,16bit)";
   record_index = 0
 }
 {
@@ -66,7 +71,8 @@ END {
         || name ~ /Tm1637\(SimpleTmi1637\)/ \
         || name ~ /Tm1638\(SimpleTmi1638\)/ \
         || name ~ /Max7219\(HardSpi\)/ \
-        || name ~ /Ht16k33\(TwoWire\)/) {
+        || name ~ /Ht16k33\(TwoWire\)/ \
+        || name ~ /Hc595\(HardSpi,NoRemap\)/) {
       printf(\
         "|---------------------------------+--------------+-------------|\n")
     }
@@ -47,16 +47,23 @@ SOFTWARE.
 #define ACE_SEGMENT_VERSION_STRING "0.12.0"
 
 #include "ace_segment/hw/ClockInterface.h"
+#include "ace_segment/hw/TimerInterface.h"
 #include "ace_segment/hw/GpioInterface.h"
 #include "ace_segment/hw/remap.h"
 #include "ace_segment/scanning/LedMatrixDirect.h"
 #include "ace_segment/scanning/LedMatrixSingleHc595.h"
 #include "ace_segment/scanning/LedMatrixDualHc595.h"
 #include "ace_segment/LedModule.h"
+#include "ace_segment/LedCanvas.h"
+#include "ace_segment/TimingProbe.h"
+#include "ace_segment/scanning/ScanningOptions.h"
 #include "ace_segment/scanning/ScanningModule.h"
+#include "ace_segment/scanning/ScanningGroup.h"
+#include "ace_segment/scanning/PerceivedBrightness.h"
 #include "ace_segment/direct/DirectModule.h"
 #include "ace_segment/hybrid/HybridModule.h"
 #include "ace_segment/hc595/Hc595Module.h"
+#include "ace_segment/dotmatrix/DotMatrixModule.h"
 #include "ace_segment/tm1637/Tm1637Module.h"
 #include "ace_segment/tm1638/Tm1638Module.h"
 #include "ace_segment/tm1638/Tm1638AnodeModule.h"
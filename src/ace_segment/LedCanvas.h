@@ -0,0 +1,186 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_LED_CANVAS_H
+#define ACE_SEGMENT_LED_CANVAS_H
+
+#include <stdint.h>
+#include <string.h> // memcpy(), memset()
+#include "LedModule.h"
+
+namespace ace_segment {
+
+/**
+ * An off-screen buffer of segment patterns which is wider than the LED module,
+ * with a viewport that selects which `getNumDigits()` consecutive patterns are
+ * shown on the module. The canvas is circular, so scrolling past the last
+ * position wraps around to position 0. Pad the canvas with blank patterns to
+ * separate the end of a message from its beginning.
+ *
+ * Scrolling changes only the offset of the viewport, instead of moving the
+ * patterns in the canvas. The visible patterns are then copied into the
+ * LedModule using LedModule::setPatterns(), which marks dirty only the digits
+ * whose patterns actually changed, so that the next `flush()` of a controller
+ * module (e.g. Tm1637Module::flushDirty() or Max7219Module::flush() with
+ * `T_SHADOW`) transmits only those digits.
+ *
+ * Typical usage for a ticker:
+ *
+ * @verbatim
+ * LedCanvas<32> canvas(ledModule);
+ * canvas.begin();
+ * canvas.setPatterns(0, messagePatterns, 32);
+ * ...
+ * canvas.scroll(); // every 300 millis
+ * ledModule.flush();
+ * @endverbatim
+ *
+ * @tparam T_WIDTH number of patterns in the canvas, which should be at least
+ *    the number of digits of the LedModule
+ * @tparam T_LED_MODULE (optional) type of the module, LedModule by default.
+ *    Modules with more than 8 digits have a different base class, so they
+ *    must be given here, e.g. `LedCanvas<32, DirectModule<12>>`.
+ */
+template <uint8_t T_WIDTH, typename T_LED_MODULE = LedModule>
+class LedCanvas {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param ledModule module which displays the viewport
+     */
+    explicit LedCanvas(T_LED_MODULE& ledModule) :
+        mLedModule(ledModule)
+    {}
+
+    /** Blank the canvas and move the viewport to position 0. */
+    void begin() {
+      memset(mPatterns, 0, T_WIDTH);
+      mOffset = 0;
+      updateModule();
+    }
+
+    /** A no-op end() function for consistency with other classes. */
+    void end() {}
+
+    /** Return the number of patterns in the canvas. */
+    uint8_t getWidth() const { return T_WIDTH; }
+
+    /**
+     * Set the pattern at position `pos` of the canvas, updating the LedModule
+     * if the position is visible.
+     */
+    void setPatternAt(uint8_t pos, uint8_t pattern) {
+      if (pos >= T_WIDTH) return;
+      mPatterns[pos] = pattern;
+      uint8_t digit = digitOf(pos);
+      if (digit < mLedModule.getNumDigits()) {
+        mLedModule.setPatternAt(digit, pattern);
+      }
+    }
+
+    /** Get the pattern at position `pos` of the canvas. */
+    uint8_t getPatternAt(uint8_t pos) const {
+      return mPatterns[pos];
+    }
+
+    /**
+     * Copy `len` patterns into the canvas starting at position `pos`. The
+     * caller must ensure that `pos + len <= getWidth()`.
+     */
+    void setPatterns(uint8_t pos, const uint8_t* patterns, uint8_t len) {
+      memcpy(mPatterns + pos, patterns, len);
+      updateModule();
+    }
+
+    /** Set all patterns of the canvas to `pattern`. */
+    void fillPatterns(uint8_t pattern) {
+      memset(mPatterns, pattern, T_WIDTH);
+      updateModule();
+    }
+
+    /** Return the canvas position shown on digit 0 of the LedModule. */
+    uint8_t getOffset() const { return mOffset; }
+
+    /** Show the canvas starting at position `offset` on digit 0. */
+    void setOffset(uint8_t offset) {
+      mOffset = offset % T_WIDTH;
+      updateModule();
+    }
+
+    /**
+     * Move the viewport by `n` positions. A positive `n` moves the contents of
+     * the display towards digit 0, which is the normal direction of a ticker.
+     */
+    void scroll(int8_t n = 1) {
+      int16_t offset = ((int16_t) mOffset + n) % T_WIDTH;
+      if (offset < 0) offset += T_WIDTH;
+      setOffset(offset);
+    }
+
+  private:
+    // disable copy-constructor and assignment operator
+    LedCanvas(const LedCanvas&) = delete;
+    LedCanvas& operator=(const LedCanvas&) = delete;
+
+    /**
+     * Return the distance of canvas position `pos` from the offset, wrapping
+     * around the end of the canvas, in the range [0, T_WIDTH). This is the
+     * digit of the LedModule which shows `pos` if it is less than
+     * getNumDigits(), otherwise `pos` is not visible.
+     */
+    uint8_t digitOf(uint8_t pos) const {
+      return (pos >= mOffset) ? pos - mOffset : pos + T_WIDTH - mOffset;
+    }
+
+    /**
+     * Copy the visible patterns into the LedModule, in contiguous runs of the
+     * canvas, so that only the digits which changed are marked dirty.
+     */
+    void updateModule() {
+      uint8_t numDigits = mLedModule.getNumDigits();
+      uint8_t digit = 0;
+      uint8_t pos = mOffset;
+      while (digit < numDigits) {
+        uint8_t len = T_WIDTH - pos;
+        if (len > numDigits - digit) len = numDigits - digit;
+        mLedModule.setPatterns(digit, mPatterns + pos, len);
+        digit += len;
+        pos = 0;
+      }
+    }
+
+    /** Module which displays the viewport. */
+    T_LED_MODULE& mLedModule;
+
+    /** Patterns of the canvas. */
+    uint8_t mPatterns[T_WIDTH];
+
+    /** Canvas position shown on digit 0. */
+    uint8_t mOffset;
+};
+
+}
+
+#endif
@@ -26,9 +26,82 @@ SOFTWARE.
 #define ACE_SEGMENT_LED_MODULE_H
 
 #include <stdint.h>
+#include <string.h> // memset()
 
 namespace ace_segment {
 
+namespace internal {
+
+/**
+ * The dirty bits of the digits of a BasicLedModule, one bit per digit, packed
+ * into T_NUM_BYTES bytes. The specialization for a single byte is a plain
+ * `uint8_t`, so that modules with 8 digits or fewer pay nothing for the
+ * support of larger modules.
+ *
+ * @tparam T_NUM_BYTES number of bytes, BasicLedModule::numDirtyBytes(T_DIGITS)
+ */
+template <uint8_t T_NUM_BYTES>
+class DigitDirtyBits {
+  public:
+    void set(uint8_t pos) { mBits[pos / 8] |= (1 << (pos % 8)); }
+
+    void clear(uint8_t pos) { mBits[pos / 8] &= ~(1 << (pos % 8)); }
+
+    bool isSet(uint8_t pos) const { return mBits[pos / 8] & (1 << (pos % 8)); }
+
+    /**
+     * Set the bits of the first `numDigits` digits. The unused bits in the
+     * last byte are left cleared, otherwise isAnySet() would never become false
+     * after all the digits have been flushed individually.
+     */
+    void setAll(uint8_t numDigits) {
+      memset(mBits, 0xFF, T_NUM_BYTES);
+      uint8_t extraBits = numDigits % 8;
+      if (extraBits) {
+        mBits[T_NUM_BYTES - 1] = (1 << extraBits) - 1;
+      }
+    }
+
+    void clearAll() { memset(mBits, 0, T_NUM_BYTES); }
+
+    bool isAnySet() const {
+      for (uint8_t i = 0; i < T_NUM_BYTES; ++i) {
+        if (mBits[i]) return true;
+      }
+      return false;
+    }
+
+    /** Set the `bits` of the block of 8 digits which contains `pos`. */
+    void setBlock(uint8_t pos, uint8_t bits) { mBits[pos / 8] |= bits; }
+
+  private:
+    uint8_t mBits[T_NUM_BYTES];
+};
+
+/** Specialization for modules with 8 digits or fewer. */
+template <>
+class DigitDirtyBits<1> {
+  public:
+    void set(uint8_t pos) { mBits |= (1 << pos); }
+
+    void clear(uint8_t pos) { mBits &= ~(1 << pos); }
+
+    bool isSet(uint8_t pos) const { return mBits & (1 << pos); }
+
+    void setAll(uint8_t numDigits) { mBits = (1 << numDigits) - 1; }
+
+    void clearAll() { mBits = 0; }
+
+    bool isAnySet() const { return mBits != 0; }
+
+    void setBlock(uint8_t /*pos*/, uint8_t bits) { mBits |= bits; }
+
+  private:
+    uint8_t mBits;
+};
+
+} // internal
+
 /**
  * General interface that represents a generic seven-segment LED module with
  * multiple digits. Subclasses will support different driver chips (e.g. TM1637,
@@ -40,14 +113,42 @@ namespace ace_segment {
  * is 'G' segment, and bit 7 is the decimal point. If an LED module does not
  * conform to this convention, the implementation class for that hardware must
  * remap the digit and segment addresses.
+ *
+ * Each digit has a dirty bit which is set by setPatternAt(). The bits are
+ * packed into T_DIRTY_BYTES bytes, so that LED modules with more than 8 digits
+ * (e.g. 16-digit scanning modules) retain the dirty information of every
+ * digit. Subclasses pass numDirtyBytes(T_DIGITS). For modules with 8 digits or
+ * fewer, the bits are a single `uint8_t`, and the base class is LedModule (or
+ * LedModule16), so that such modules can be passed around as an `LedModule&`.
+ *
+ * The pattern of a digit is a T_PATTERN. Seven-segment modules use the
+ * LedModule alias with `uint8_t` patterns. The 14-segment and 16-segment
+ * alphanumeric modules use `uint16_t` patterns (LedModule16), where bits 0 to
+ * 13 (or 15) are the segments in the order of the controller, and the
+ * decimal point is the bit after the last segment.
+ *
+ * @tparam T_PATTERN type of the segment pattern of one digit, `uint8_t` or
+ *    `uint16_t`
+ * @tparam T_DIRTY_BYTES (optional) number of bytes of dirty bits,
+ *    numDirtyBytes(T_DIGITS) (default: 1, for at most 8 digits)
  */
-class LedModule {
+template <typename T_PATTERN, uint8_t T_DIRTY_BYTES = 1>
+class BasicLedModule {
   public:
+    /**
+     * Return the number of bytes needed to hold one dirty bit for each of
+     * `numDigits` digits, which is the T_DIRTY_BYTES of a module with
+     * `numDigits` digits.
+     */
+    static constexpr uint8_t numDirtyBytes(uint8_t numDigits) {
+      return (numDigits + 7) / 8;
+    }
+
     /**
      * Constructor.
      *
-     * @param patterns pointer to an array of bytes representing LED segment
-     *    patterns
+     * @param patterns pointer to an array of T_PATTERN representing LED
+     *    segment patterns
      * @param numDigits number of digits in the LED module; this value is
      *    returned by getNumDigits(). The value is usually a compile-time
      *    constant passed in through a template parameter, so it is faster and
@@ -55,7 +156,7 @@ class LedModule {
      *    code needs this value but it has only a reference or pointer to the
      *    LedModule. Then getNumDigits() can be used.
      */
-    explicit LedModule(uint8_t* patterns, uint8_t numDigits) :
+    explicit BasicLedModule(T_PATTERN* patterns, uint8_t numDigits) :
         mPatterns(patterns),
         mNumDigits(numDigits)
     {}
@@ -63,17 +164,89 @@ class LedModule {
     /** Return the number of digits supported by this display instance. */
     uint8_t getNumDigits() const { return mNumDigits; }
 
-    /** Set the led digit pattern at position pos. */
-    void setPatternAt(uint8_t pos, uint8_t pattern) {
+    /**
+     * Set the led digit pattern at position pos. The digit is marked dirty only
+     * if the pattern actually changed, so that an application which redraws
+     * the entire display on every iteration does not trigger a flush() of
+     * identical data to the LED controller.
+     */
+    void setPatternAt(uint8_t pos, T_PATTERN pattern) {
+      if (mPatterns[pos] == pattern) return;
       mPatterns[pos] = pattern;
       setDigitDirty(pos);
     }
 
     /** Get the led digit pattern at position pos. */
-    uint8_t getPatternAt(uint8_t pos) const {
+    T_PATTERN getPatternAt(uint8_t pos) const {
       return mPatterns[pos];
     }
 
+    /**
+     * Copy `len` patterns from `patterns` into the digits starting at position
+     * `pos`. Only the digits whose patterns changed are marked dirty, and the
+     * dirty bits are written once per 8 digits instead of once per digit. The
+     * caller must ensure that `pos + len <= getNumDigits()`.
+     */
+    void setPatterns(uint8_t pos, const T_PATTERN* patterns, uint8_t len) {
+      uint8_t dirty = 0;
+      for (uint8_t i = 0; i < len; ++i, ++pos) {
+        storePattern(pos, patterns[i], dirty);
+        if ((pos % 8) == 7 || i == len - 1) {
+          mDigitDirtyBits.setBlock(pos, dirty);
+          dirty = 0;
+        }
+      }
+    }
+
+    /** Set all digits to the same `pattern`, e.g. 0 to clear the display. */
+    void fillPatterns(T_PATTERN pattern) {
+      storePatterns(0, mNumDigits, pattern);
+    }
+
+    /**
+     * Shift the patterns of all digits by `n` positions. If `n` is positive,
+     * the patterns move towards position 0 (i.e. scroll to the left on a
+     * typical display); if negative, they move towards the last position. The
+     * vacated digits are blanked with a pattern of 0. Only the digits whose
+     * patterns changed are marked dirty.
+     */
+    void shiftPatterns(int8_t n) {
+      if (n >= 0) {
+        uint8_t shift = n;
+        if (shift >= mNumDigits) {
+          fillPatterns(0);
+          return;
+        }
+        uint8_t numMoved = mNumDigits - shift;
+        uint8_t dirty = 0;
+        for (uint8_t pos = 0; pos < numMoved; ++pos) {
+          storePattern(pos, mPatterns[pos + shift], dirty);
+          if ((pos % 8) == 7 || pos == numMoved - 1) {
+            mDigitDirtyBits.setBlock(pos, dirty);
+            dirty = 0;
+          }
+        }
+        storePatterns(numMoved, shift, 0);
+      } else {
+        uint8_t shift = -n;
+        if (shift >= mNumDigits) {
+          fillPatterns(0);
+          return;
+        }
+        // Iterate backwards, so that each source digit is read before it is
+        // overwritten.
+        uint8_t dirty = 0;
+        for (uint8_t pos = mNumDigits - 1; pos >= shift; --pos) {
+          storePattern(pos, mPatterns[pos - shift], dirty);
+          if ((pos % 8) == 0 || pos == shift) {
+            mDigitDirtyBits.setBlock(pos, dirty);
+            dirty = 0;
+          }
+        }
+        storePatterns(0, shift, 0);
+      }
+    }
+
     /**
      * Set global brightness of all digits. Different subclasses will interpret
      * the brightness integer value differently.
@@ -94,7 +267,7 @@ class LedModule {
       // Dirty bits are set to true so that the first refresh sends the current
       // pattern to the LED module. Otherwise, nothing will be displayed until
       // a setPatternAt() or setBrightness() is called.
-      mDigitDirtyBits = 0xFF;
+      setDigitsDirty();
       mIsBrightnessDirty = true;
 
       // On some LEDs, level 0 turns off the display, but on others level 0 is
@@ -109,27 +282,81 @@ class LedModule {
 
     /** Set the dirty bit of digit `pos`. */
     void setDigitDirty(uint8_t pos) {
-      mDigitDirtyBits |= (1 << pos);
+      mDigitDirtyBits.set(pos);
     }
 
     /** Clear the dirty bit of digit `pos`. */
     void clearDigitDirty(uint8_t pos) {
-      mDigitDirtyBits &= ~(1 << pos);
+      mDigitDirtyBits.clear(pos);
     }
 
     /** Check the dirty bit of digit `pos`. */
     bool isDigitDirty(uint8_t pos) const {
-      return mDigitDirtyBits & (1 << pos);
+      return mDigitDirtyBits.isSet(pos);
+    }
+
+    /** Set the dirty bits of all digits, leaving the unused bits cleared. */
+    void setDigitsDirty() {
+      mDigitDirtyBits.setAll(mNumDigits);
     }
 
     /** Clear dirty bits of all digits. */
     void clearDigitsDirty() {
-      mDigitDirtyBits = 0x0;
+      mDigitDirtyBits.clearAll();
     }
 
     /** Return true if any digits are dirty. */
     bool isAnyDigitDirty() const {
-      return mDigitDirtyBits != 0;
+      return mDigitDirtyBits.isAnySet();
+    }
+
+    /**
+     * Find the next run of consecutive chip positions whose digits are dirty,
+     * starting the search at `chipPos`. Controllers with an auto-increment
+     * address mode can send each run as a single burst, instead of sending
+     * every digit, or each dirty digit with its own address command.
+     *
+     * Each chip position `i` is mapped to the digit `remapArray[i]` (or `i`
+     * if `remapArray` is null) whose dirty bit is checked, so the runs are
+     * contiguous in the address space of the chip, not in the logical digit
+     * positions. The `remapArray` may map more than one chip position to the
+     * same digit, if the module has more chip positions than digits.
+     *
+     * Typical usage:
+     *
+     * @code
+     * uint8_t beginPos = 0;
+     * while (true) {
+     *   uint8_t endPos = nextDirtyRun(beginPos, numChipPos, remapArray);
+     *   if (beginPos == endPos) break;
+     *   // send chip positions [beginPos, endPos) in one burst
+     *   beginPos = endPos;
+     * }
+     * @endcode
+     *
+     * @param chipPos [in/out] the chip position where the search starts. Set
+     *    to the first chip position of the run, or to `numChipPos` if there are
+     *    no more dirty digits.
+     * @param numChipPos number of chip positions
+     * @param remapArray (nullable) map of chip position to digit position
+     * @return the chip position one past the end of the run, which is equal to
+     *    `chipPos` if there is no run
+     */
+    uint8_t nextDirtyRun(
+        uint8_t& chipPos,
+        uint8_t numChipPos,
+        const uint8_t* remapArray
+    ) const {
+      while (chipPos < numChipPos
+          && ! isDigitDirty(remapArray ? remapArray[chipPos] : chipPos)) {
+        chipPos++;
+      }
+      uint8_t endPos = chipPos;
+      while (endPos < numChipPos
+          && isDigitDirty(remapArray ? remapArray[endPos] : endPos)) {
+        endPos++;
+      }
+      return endPos;
     }
 
     /** Check if the brightness level is dirty. */
@@ -149,20 +376,49 @@ class LedModule {
 
   private:
     // disable copy-constructor and assignment operator
-    LedModule(const LedModule&) = delete;
-    LedModule& operator=(const LedModule&) = delete;
+    BasicLedModule(const BasicLedModule&) = delete;
+    BasicLedModule& operator=(const BasicLedModule&) = delete;
+
+    /**
+     * Write `pattern` into digit `pos` if it differs from the current pattern,
+     * accumulating its dirty bit into `dirty` which is the pending dirty byte
+     * for the block of 8 digits containing `pos`.
+     */
+    void storePattern(uint8_t pos, T_PATTERN pattern, uint8_t& dirty) {
+      if (mPatterns[pos] == pattern) return;
+      mPatterns[pos] = pattern;
+      dirty |= (1 << (pos % 8));
+    }
+
+    /** Set `len` digits starting at `pos` to the same `pattern`. */
+    void storePatterns(uint8_t pos, uint8_t len, T_PATTERN pattern) {
+      uint8_t dirty = 0;
+      for (uint8_t i = 0; i < len; ++i, ++pos) {
+        storePattern(pos, pattern, dirty);
+        if ((pos % 8) == 7 || i == len - 1) {
+          mDigitDirtyBits.setBlock(pos, dirty);
+          dirty = 0;
+        }
+      }
+    }
 
   private:
     // The order of these instance variables is partially motivated to save
     // memory on 32-bit processors.
-    uint8_t* const mPatterns;
+    T_PATTERN* const mPatterns;
     uint8_t const mNumDigits;
 
-    uint8_t mDigitDirtyBits; // array of 8 dirty bits
+    internal::DigitDirtyBits<T_DIRTY_BYTES> mDigitDirtyBits;
     uint8_t mBrightness;
     bool mIsBrightnessDirty;
 };
 
+/** An LedModule of seven-segment digits, with 8-bit patterns. */
+using LedModule = BasicLedModule<uint8_t>;
+
+/** An LedModule of 14-segment or 16-segment digits, with 16-bit patterns. */
+using LedModule16 = BasicLedModule<uint16_t>;
+
 } // ace_segment
 
 #endif
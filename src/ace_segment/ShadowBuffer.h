@@ -0,0 +1,120 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef ACE_SEGMENT_SHADOW_BUFFER_H
+#define ACE_SEGMENT_SHADOW_BUFFER_H
+
+#include <stdint.h>
+
+namespace ace_segment {
+namespace internal {
+
+/**
+ * A copy of the last bytes transmitted to an LED controller chip, in the
+ * address order of the chip. The controller modules compare each outgoing byte
+ * against the shadow copy and skip the bytes that the chip already holds. This
+ * also catches a digit which is changed and then changed back before the next
+ * flush(), which would otherwise be transmitted because its dirty bit is set.
+ *
+ * The controller modules inherit from this class privately, so that the
+ * disabled specialization below is optimized away by the empty base class
+ * optimization.
+ *
+ * @tparam T_SIZE number of bytes in the shadow copy
+ * @tparam T_ENABLED true to enable the shadow copy
+ */
+template <uint8_t T_SIZE, bool T_ENABLED>
+class ShadowBuffer {
+  public:
+    /**
+     * Forget the contents of the chip, so that the next update() of every
+     * position returns true. This must be called when the state of the chip is
+     * unknown, for example in begin().
+     */
+    void invalidateShadow() {
+      mIsShadowValid = false;
+    }
+
+    /**
+     * Mark the shadow copy valid after every position was transmitted
+     * unconditionally through update().
+     */
+    void validateShadow() {
+      mIsShadowValid = true;
+    }
+
+    /**
+     * Return true if the shadow copy matches the chip. Until then, the
+     * controller modules must send every position, e.g. by calling flush().
+     */
+    bool isShadowValid() const {
+      return mIsShadowValid;
+    }
+
+    /**
+     * Return true if `value` must be sent to position `pos` of the chip, and
+     * record it as the value held by the chip.
+     */
+    bool updateShadow(uint8_t pos, uint8_t value) {
+      if (mIsShadowValid && mShadow[pos] == value) return false;
+      mShadow[pos] = value;
+      return true;
+    }
+
+    /** Return true if `value` differs from the shadow copy at `pos`. */
+    bool isShadowDifferent(uint8_t pos, uint8_t value) const {
+      return !mIsShadowValid || mShadow[pos] != value;
+    }
+
+  private:
+    uint8_t mShadow[T_SIZE];
+    bool mIsShadowValid = false;
+};
+
+/**
+ * Specialization used when the shadow copy is disabled. Every byte is assumed
+ * to be different, so the controller modules fall back to sending all of them.
+ */
+template <uint8_t T_SIZE>
+class ShadowBuffer<T_SIZE, false> {
+  public:
+    void invalidateShadow() {}
+
+    void validateShadow() {}
+
+    /** Always true, since there is no shadow copy to synchronize. */
+    bool isShadowValid() const { return true; }
+
+    bool updateShadow(uint8_t /*pos*/, uint8_t /*value*/) { return true; }
+
+    bool isShadowDifferent(uint8_t /*pos*/, uint8_t /*value*/) const {
+      return true;
+    }
+};
+
+} // internal
+} // ace_segment
+
+#endif
@@ -0,0 +1,248 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_TIMING_PROBE_H
+#define ACE_SEGMENT_TIMING_PROBE_H
+
+#include <stdint.h>
+#include "hw/ClockInterface.h"
+
+namespace ace_segment {
+
+/**
+ * A snapshot of the statistics collected by a TimingProbe. All durations are
+ * in microseconds.
+ */
+struct TimingProbeStats {
+  /** Number of calls, saturated at 2^32-1. */
+  uint32_t numCalls;
+
+  /** Number of calls which took longer than the budget. */
+  uint16_t numOverruns;
+
+  /** Shortest call. */
+  uint16_t minMicros;
+
+  /** Longest call. */
+  uint16_t maxMicros;
+
+  /**
+   * Average of the recent calls. It is the exact average of all calls up to
+   * TimingProbe::kAverageWindow calls, then a decaying average which weighs
+   * the last kAverageWindow calls most, so that it keeps tracking the
+   * durations of a long running module.
+   */
+  uint16_t avgMicros;
+};
+
+/**
+ * The default T_PROBE of the LED modules. It measures nothing, has no data
+ * members, and all of its methods are empty, so the instrumentation hooks
+ * compile away, at no cost in flash, RAM or CPU.
+ */
+class NoTimingProbe {
+  public:
+    /** Number of durations kept by getRecentMicros(). */
+    static const uint8_t kHistorySize = 0;
+
+    void resetTiming() {}
+
+    void setBudgetMicros(uint16_t /*budgetMicros*/) {}
+
+    uint16_t getBudgetMicros() const { return 0; }
+
+    TimingProbeStats getStats() const {
+      TimingProbeStats stats = {0, 0, 0, 0, 0};
+      return stats;
+    }
+
+    uint16_t getRecentMicros(uint8_t /*i*/) const { return 0; }
+
+    uint16_t startTiming() const { return 0; }
+
+    void stopTiming(uint16_t /*startMicros*/) {}
+};
+
+/**
+ * A T_PROBE which records the duration of each call to the instrumented
+ * methods of an LED module: ScanningModule::renderFieldNow(), or the flush()
+ * methods of the controller modules (e.g. Tm1637Module::flush(),
+ * flushIncremental() and flushDirty(), which share one probe). It keeps the
+ * number of calls, the min/avg/max durations, the number of calls exceeding a
+ * budget, and the last T_HISTORY durations, in `19 + 2 * T_HISTORY` bytes.
+ *
+ * If the instrumented method runs in an interrupt handler, the statistics
+ * should be read with interrupts disabled, because they are multi-byte
+ * values on 8-bit processors.
+ *
+ * @tparam T_HISTORY number of most recent durations to keep, at least 1
+ *    (default: 4)
+ * @tparam T_CI class that provides micros() (default: ClockInterface)
+ */
+template <uint8_t T_HISTORY = 4, typename T_CI = ClockInterface>
+class TimingProbe {
+    static_assert(T_HISTORY > 0, "T_HISTORY must be at least 1");
+
+  public:
+    /** Number of durations kept by getRecentMicros(). */
+    static const uint8_t kHistorySize = T_HISTORY;
+
+    /**
+     * Number of calls averaged exactly by avgMicros. When the window is full,
+     * the sum and the count of the window are halved, which keeps the sum
+     * from overflowing and lets the average follow the recent durations.
+     */
+    static const uint16_t kAverageWindow = 1024;
+
+    TimingProbe() :
+        mBudgetMicros(0)
+    {
+      resetTiming();
+    }
+
+    /** Clear the statistics, but not the budget. */
+    void resetTiming() {
+      mNumCalls = 0;
+      mNumOverruns = 0;
+      mMinMicros = 0xFFFF;
+      mMaxMicros = 0;
+      mWindowSumMicros = 0;
+      mWindowCalls = 0;
+      mHistoryIndex = 0;
+      for (uint8_t i = 0; i < T_HISTORY; ++i) {
+        mHistory[i] = 0;
+      }
+    }
+
+    /**
+     * Set the maximum duration of a call, in micros. A call taking longer is
+     * counted as an overrun. A budget of 0 (the default) disables the
+     * overrun counter. ScanningModule::begin() sets the budget to
+     * getMicrosPerField().
+     */
+    void setBudgetMicros(uint16_t budgetMicros) {
+      mBudgetMicros = budgetMicros;
+    }
+
+    /** Return the budget. */
+    uint16_t getBudgetMicros() const { return mBudgetMicros; }
+
+    /** Return a snapshot of the statistics. */
+    TimingProbeStats getStats() const {
+      TimingProbeStats stats;
+      stats.numCalls = mNumCalls;
+      stats.numOverruns = mNumOverruns;
+      stats.minMicros = (mNumCalls == 0) ? 0 : mMinMicros;
+      stats.maxMicros = mMaxMicros;
+      stats.avgMicros = (mWindowCalls == 0)
+          ? 0
+          : (mWindowSumMicros + mWindowCalls / 2) / mWindowCalls; // rounded
+      return stats;
+    }
+
+    /**
+     * Return the duration of the i'th most recent call, where 0 is the latest
+     * call. Returns 0 if i >= T_HISTORY, or if there were fewer calls.
+     */
+    uint16_t getRecentMicros(uint8_t i) const {
+      if (i >= T_HISTORY) return 0;
+      uint8_t index = mHistoryIndex + T_HISTORY - 1 - i;
+      if (index >= T_HISTORY) index -= T_HISTORY;
+      return mHistory[index];
+    }
+
+    /** Called at the start of an instrumented method. */
+    uint16_t startTiming() const {
+      return T_CI::micros();
+    }
+
+    /** Called at the end of an instrumented method. */
+    void stopTiming(uint16_t startMicros) {
+      const uint16_t elapsedMicros = (uint16_t) T_CI::micros() - startMicros;
+
+      if (mBudgetMicros != 0
+          && elapsedMicros > mBudgetMicros
+          && mNumOverruns != 0xFFFF) {
+        mNumOverruns++;
+      }
+      if (elapsedMicros < mMinMicros) mMinMicros = elapsedMicros;
+      if (elapsedMicros > mMaxMicros) mMaxMicros = elapsedMicros;
+
+      if (mNumCalls != 0xFFFFFFFF) mNumCalls++;
+
+      // Halve the window when it is full. The sum stays below
+      // kAverageWindow * 65535, which fits in 32 bits.
+      if (mWindowCalls >= kAverageWindow) {
+        mWindowCalls /= 2;
+        mWindowSumMicros /= 2;
+      }
+      mWindowCalls++;
+      mWindowSumMicros += elapsedMicros;
+
+      mHistory[mHistoryIndex] = elapsedMicros;
+      mHistoryIndex++;
+      if (mHistoryIndex >= T_HISTORY) mHistoryIndex = 0;
+    }
+
+  private:
+    uint32_t mNumCalls;
+    uint32_t mWindowSumMicros;
+    uint16_t mWindowCalls;
+    uint16_t mNumOverruns;
+    uint16_t mMinMicros;
+    uint16_t mMaxMicros;
+    uint16_t mBudgetMicros;
+    uint16_t mHistory[T_HISTORY];
+
+    /** Index of mHistory where the next duration is written. */
+    uint8_t mHistoryIndex;
+};
+
+namespace internal {
+
+/**
+ * Times the enclosing scope of an instrumented method using the T_PROBE of
+ * the LED module. Compiles to nothing for NoTimingProbe.
+ */
+template <typename T_PROBE>
+class TimingProbeScope {
+  public:
+    explicit TimingProbeScope(T_PROBE& probe) :
+        mProbe(probe),
+        mStartMicros(probe.startTiming())
+    {}
+
+    ~TimingProbeScope() {
+      mProbe.stopTiming(mStartMicros);
+    }
+
+  private:
+    T_PROBE& mProbe;
+    uint16_t const mStartMicros;
+};
+
+} // namespace internal
+} // namespace ace_segment
+
+#endif
@@ -48,6 +48,12 @@ namespace ace_segment {
  *    and micros()). The default is ClockInterface.
  * @tparam T_GPIOI (optional) class that provides access to the GPIO pins,
  *    default is GpioInterface (note: 'GPI' is already taken on ESP8266)
+ * @tparam T_OPTIONS bit mask of the optional `kScanningOptionXxx` features of
+ *    ScanningModule (default: 0)
+ * @tparam T_PROBE (optional) instrumentation policy which times
+ *    renderFieldNow(), e.g. TimingProbe<> (default: NoTimingProbe)
+ * @tparam T_TIMER (optional) hardware timer which drives renderFieldNow()
+ *    after startTimer(), e.g. TimerOneInterface (default: NoTimerInterface)
  */
 template <
     uint8_t e0, uint8_t e1, uint8_t e2, uint8_t e3,
@@ -55,20 +61,35 @@ template <
     uint8_t g0, uint8_t g1, uint8_t g2, uint8_t g3,
     uint8_t T_DIGITS,
     uint8_t T_SUBFIELDS = 1,
-    typename T_CI = ClockInterface
+    typename T_CI = ClockInterface,
+    uint16_t T_OPTIONS = 0,
+    typename T_PROBE = NoTimingProbe,
+    typename T_TIMER = NoTimerInterface
 >
 class DirectFast4Module : public ScanningModule<
     LedMatrixDirectFast4<e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>,
     T_DIGITS,
     T_SUBFIELDS,
-    T_CI
+    T_CI,
+    T_OPTIONS,
+    DirectFast4Module<
+        e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3,
+        T_DIGITS, T_SUBFIELDS, T_CI, T_OPTIONS, T_PROBE, T_TIMER>,
+    T_PROBE,
+    T_TIMER
 > {
   private:
     using Super = ScanningModule<
         LedMatrixDirectFast4<e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>,
         T_DIGITS,
         T_SUBFIELDS,
-        T_CI
+        T_CI,
+        T_OPTIONS,
+        DirectFast4Module<
+            e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3,
+            T_DIGITS, T_SUBFIELDS, T_CI, T_OPTIONS, T_PROBE, T_TIMER>,
+        T_PROBE,
+        T_TIMER
     >;
 
   public:
@@ -77,7 +98,7 @@ class DirectFast4Module : public ScanningModule<
         uint8_t digitOnPattern,
         uint8_t framesPerSecond
     ) :
-        Super(mLedMatrix, framesPerSecond),
+        Super(framesPerSecond),
         mLedMatrix(
             segmentOnPattern /*elementOnPattern*/,
             digitOnPattern /*groupOnPattern*/
@@ -95,6 +116,9 @@ class DirectFast4Module : public ScanningModule<
     }
 
   private:
+    // ScanningModule accesses mLedMatrix directly.
+    friend Super;
+
     LedMatrixDirectFast4<e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>
         mLedMatrix;
 };
@@ -30,6 +30,27 @@ SOFTWARE.
 
 namespace ace_segment {
 
+namespace internal {
+
+/**
+ * The LedMatrixDirect of a DirectModule. With kScanningOptionSegmentMajor, the
+ * digits are the elements of the LedMatrix, so more than 8 digits need the
+ * 16-bit element pattern. Otherwise the elements are the 8 segments.
+ */
+template <typename T_GPIOI, uint8_t T_DIGITS, uint16_t T_OPTIONS>
+struct DirectLedMatrix {
+  typedef LedMatrixDirect<
+      T_GPIOI,
+      typename Conditional<
+          ((T_OPTIONS & kScanningOptionSegmentMajor) != 0 && T_DIGITS > 8),
+          uint16_t,
+          uint8_t
+      >::Type
+  > Type;
+};
+
+} // internal
+
 /**
  * An implementation of LedModule whose segment and digit pins are directly
  * connected to the GPIO pins of the microcontroller. This is a convenience
@@ -45,25 +66,48 @@ namespace ace_segment {
  *    and micros()). The default is ClockInterface.
  * @tparam T_GPIOI (optional) class that provides access to the GPIO pins,
  *    default is GpioInterface (note: 'GPI' is already taken on ESP8266)
+ * @tparam T_OPTIONS bit mask of the optional `kScanningOptionXxx` features of
+ *    ScanningModule (default: 0). With kScanningOptionSegmentMajor, the
+ *    module scans the 8 segment pins instead of the T_DIGITS digit pins.
+ * @tparam T_PROBE (optional) instrumentation policy which times
+ *    renderFieldNow(), e.g. TimingProbe<> (default: NoTimingProbe)
+ * @tparam T_TIMER (optional) hardware timer which drives renderFieldNow()
+ *    after startTimer(), e.g. TimerOneInterface (default: NoTimerInterface)
  */
 template <
     uint8_t T_DIGITS,
     uint8_t T_SUBFIELDS = 1,
     typename T_CI = ClockInterface,
-    typename T_GPIOI = GpioInterface
+    typename T_GPIOI = GpioInterface,
+    uint16_t T_OPTIONS = 0,
+    typename T_PROBE = NoTimingProbe,
+    typename T_TIMER = NoTimerInterface
 >
 class DirectModule : public ScanningModule<
-    LedMatrixDirect<T_GPIOI>,
+    typename internal::DirectLedMatrix<T_GPIOI, T_DIGITS, T_OPTIONS>::Type,
     T_DIGITS,
     T_SUBFIELDS,
-    T_CI
+    T_CI,
+    T_OPTIONS,
+    DirectModule<
+        T_DIGITS, T_SUBFIELDS, T_CI, T_GPIOI, T_OPTIONS, T_PROBE, T_TIMER>,
+    T_PROBE,
+    T_TIMER
 > {
   private:
+    using LedMatrix =
+        typename internal::DirectLedMatrix<T_GPIOI, T_DIGITS, T_OPTIONS>::Type;
+
     using Super = ScanningModule<
-        LedMatrixDirect<T_GPIOI>,
+        LedMatrix,
         T_DIGITS,
         T_SUBFIELDS,
-        T_CI
+        T_CI,
+        T_OPTIONS,
+        DirectModule<
+            T_DIGITS, T_SUBFIELDS, T_CI, T_GPIOI, T_OPTIONS, T_PROBE, T_TIMER>,
+        T_PROBE,
+        T_TIMER
     >;
 
   public:
@@ -74,14 +118,14 @@ class DirectModule : public ScanningModule<
         const uint8_t* segmentPins,
         const uint8_t* digitPins
     ) :
-        Super(mLedMatrix, framesPerSecond),
+        Super(framesPerSecond),
         mLedMatrix(
-            segmentOnPattern /*elementOnPattern*/,
-            digitOnPattern /*groupOnPattern*/,
-            8 /* numElements */,
-            segmentPins /*elementPins*/,
-            T_DIGITS /*numGroups*/,
-            digitPins /* groupPins */
+            kSegmentMajor ? digitOnPattern : segmentOnPattern,
+            kSegmentMajor ? segmentOnPattern : digitOnPattern,
+            kSegmentMajor ? T_DIGITS : 8 /*numElements*/,
+            kSegmentMajor ? digitPins : segmentPins /*elementPins*/,
+            kSegmentMajor ? 8 : T_DIGITS /*numGroups*/,
+            kSegmentMajor ? segmentPins : digitPins /*groupPins*/
         )
     {}
 
@@ -96,7 +140,17 @@ class DirectModule : public ScanningModule<
     }
 
   private:
-    LedMatrixDirect<T_GPIOI> mLedMatrix;
+    /**
+     * With kScanningOptionSegmentMajor, the segments are the groups of the
+     * LedMatrix, and the digits are its elements.
+     */
+    static const bool kSegmentMajor =
+        (T_OPTIONS & kScanningOptionSegmentMajor) != 0;
+
+    // ScanningModule accesses mLedMatrix directly.
+    friend Super;
+
+    LedMatrix mLedMatrix;
 };
 
 } // ace_segment
@@ -0,0 +1,240 @@
+/*
+MIT License
+
+Copyright (c) 2021 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_DOT_MATRIX_MODULE_H
+#define ACE_SEGMENT_DOT_MATRIX_MODULE_H
+
+#include "../scanning/ScanningModule.h"
+
+namespace ace_segment {
+
+/**
+ * A ScanningModule for a dot matrix display, which scans one row per field.
+ * Each row of pixels is stored as a single `T_ROW` word, with column `x` in
+ * bit `x`, so that the LedMatrix draws a whole row with one call to
+ * `draw(row, rowBits)` and the interrupt service routine never loops over
+ * individual pixels. A row is a "digit" of the LedModule, so `setPatternAt()`
+ * writes a whole row, and the per-digit dirty bits track which rows changed.
+ *
+ * The bitmap operations (setPixel(), blit(), shiftLeft(), shiftUp(), etc.)
+ * work on whole rows with shifts and masks, and are meant to be called from
+ * the `loop()`. Like setPatternAt(), they mark dirty only the rows which
+ * actually changed. With kScanningOptionDoubleBuffer, a frame drawn by
+ * several operations is shown as a whole after commit(), which avoids tearing
+ * while scrolling.
+ *
+ * Typical configurations:
+ *
+ *  * 8x8: the common boards with one 74HC595 on the rows and another on the
+ *    columns, using LedMatrixDualHc595 (rows are the groups, columns are the
+ *    elements).
+ *  * 8 rows of 16 columns: `T_ROW = uint16_t`, with the rows on the
+ *    microcontroller pins and the columns on 2 daisy chained 74HC595 chips,
+ *    using `LedMatrixSingleHc595<T_SPII, GpioInterface, uint16_t>`.
+ *  * 16 rows of 8 columns: LedMatrixDirect with 16 group pins.
+ *
+ * @tparam T_LM the LedMatrixBase class that provides access to LED rows
+ *    (groups) and columns (elements)
+ * @tparam T_ROWS number of rows
+ * @tparam T_ROW type of the bits of one row, `uint8_t` for 8 columns
+ *    (default), or `uint16_t` for 16 columns
+ * @tparam T_SUBFIELDS number of PWM subfields per row, for brightness control
+ *    (default: 1)
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()). The default is ClockInterface.
+ * @tparam T_OPTIONS bit mask of the optional `kScanningOptionXxx` features of
+ *    ScanningModule (default: 0)
+ * @tparam T_PROBE (optional) instrumentation policy which times
+ *    renderFieldNow(), e.g. TimingProbe<> (default: NoTimingProbe)
+ * @tparam T_TIMER (optional) hardware timer which drives renderFieldNow()
+ *    after startTimer(), e.g. TimerOneInterface (default: NoTimerInterface)
+ */
+template <
+    typename T_LM,
+    uint8_t T_ROWS,
+    typename T_ROW = uint8_t,
+    uint8_t T_SUBFIELDS = 1,
+    typename T_CI = ClockInterface,
+    uint16_t T_OPTIONS = 0,
+    typename T_PROBE = NoTimingProbe,
+    typename T_TIMER = NoTimerInterface
+>
+class DotMatrixModule : public ScanningModule<
+    T_LM, T_ROWS, T_SUBFIELDS, T_CI, T_OPTIONS, void, T_PROBE, T_TIMER, T_ROW> {
+
+  private:
+    using Super = ScanningModule<
+        T_LM, T_ROWS, T_SUBFIELDS, T_CI, T_OPTIONS, void, T_PROBE, T_TIMER,
+        T_ROW>;
+
+  public:
+    /** Number of columns. */
+    static const uint8_t kWidth = 8 * sizeof(T_ROW);
+
+    /** Number of rows. */
+    static const uint8_t kHeight = T_ROWS;
+
+    /** Type of the bits of one column, bit `y` being row `y`. */
+    typedef typename internal::Conditional<
+        (T_ROWS > 8), uint16_t, uint8_t>::Type ColumnBits;
+
+    static_assert(T_ROWS <= 16, "DotMatrixModule supports up to 16 rows");
+
+    /**
+     * Constructor.
+     *
+     * @param ledMatrix instance of T_LM, with the rows as the groups and the
+     *    columns as the elements
+     * @param framesPerSecond the rate at which all rows of the display are
+     *    refreshed
+     */
+    DotMatrixModule(const T_LM& ledMatrix, uint8_t framesPerSecond) :
+        Super(ledMatrix, framesPerSecond)
+    {}
+
+    /** Turn off all pixels. */
+    void clear() {
+      this->fillPatterns(0);
+    }
+
+    /** Return true if the pixel at column `x` and row `y` is on. */
+    bool getPixel(uint8_t x, uint8_t y) const {
+      return (this->getPatternAt(y) >> x) & 0x1;
+    }
+
+    /** Turn the pixel at column `x` and row `y` on or off. */
+    void setPixel(uint8_t x, uint8_t y, bool on) {
+      T_ROW bit = (T_ROW) (1U << x);
+      T_ROW row = this->getPatternAt(y);
+      this->setPatternAt(y, on ? (T_ROW) (row | bit) : (T_ROW) (row & ~bit));
+    }
+
+    /** Return the pixels of column `x`, with row `y` in bit `y`. */
+    ColumnBits getColumn(uint8_t x) const {
+      ColumnBits column = 0;
+      for (uint8_t y = 0; y < T_ROWS; ++y) {
+        column |= (ColumnBits) (((this->getPatternAt(y) >> x) & 0x1) << y);
+      }
+      return column;
+    }
+
+    /**
+     * Set the pixels of column `x` from `column`, with row `y` in bit `y`.
+     * Together with shiftLeft(1), this scrolls a new column of a font into the
+     * right edge of a sign.
+     */
+    void setColumn(uint8_t x, ColumnBits column) {
+      for (uint8_t y = 0; y < T_ROWS; ++y) {
+        setPixel(x, y, (column >> y) & 0x1);
+      }
+    }
+
+    /**
+     * Copy a bitmap of `width` columns and `height` rows into the display,
+     * with its top left corner at column `x` and row `y`. Row `r` of the
+     * bitmap is `bitmap[r]`, with its column `c` in bit `c`. The pixels of the
+     * bitmap replace the pixels under it, and the parts which fall outside of
+     * the display are clipped, so negative `x` or `y` is allowed. Each row is
+     * written with one shift and one mask.
+     */
+    void blit(int8_t x, int8_t y, const T_ROW* bitmap, uint8_t width,
+        uint8_t height) {
+      if (width == 0 || width > kWidth) return;
+      if (x >= (int8_t) kWidth || x <= -(int8_t) width) return;
+
+      const T_ROW allBits = ~(T_ROW) 0;
+      const T_ROW mask = shiftColumns(allBits >> (kWidth - width), x);
+      for (uint8_t r = 0; r < height; ++r) {
+        int8_t row = y + r;
+        if (row < 0) continue;
+        if (row >= (int8_t) T_ROWS) break;
+        T_ROW bits = shiftColumns(bitmap[r], x);
+        T_ROW old = this->getPatternAt(row);
+        this->setPatternAt(row, (T_ROW) ((old & ~mask) | (bits & mask)));
+      }
+    }
+
+    /**
+     * Move all pixels `n` columns towards column 0, blanking the columns on
+     * the right.
+     */
+    void shiftLeft(uint8_t n) {
+      if (n >= kWidth) {
+        clear();
+        return;
+      }
+      for (uint8_t y = 0; y < T_ROWS; ++y) {
+        this->setPatternAt(y, (T_ROW) (this->getPatternAt(y) >> n));
+      }
+    }
+
+    /**
+     * Move all pixels `n` columns away from column 0, blanking the columns on
+     * the left.
+     */
+    void shiftRight(uint8_t n) {
+      if (n >= kWidth) {
+        clear();
+        return;
+      }
+      for (uint8_t y = 0; y < T_ROWS; ++y) {
+        this->setPatternAt(y,
+            (T_ROW) ((unsigned) this->getPatternAt(y) << n));
+      }
+    }
+
+    /** Move all rows `n` rows towards row 0, blanking the bottom rows. */
+    void shiftUp(uint8_t n) {
+      this->shiftPatterns((int8_t) ((n < T_ROWS) ? n : T_ROWS));
+    }
+
+    /** Move all rows `n` rows away from row 0, blanking the top rows. */
+    void shiftDown(uint8_t n) {
+      this->shiftPatterns(-(int8_t) ((n < T_ROWS) ? n : T_ROWS));
+    }
+
+    /** Return true if row `y` changed since the last clearRowsDirty(). */
+    bool isRowDirty(uint8_t y) const { return this->isDigitDirty(y); }
+
+    /** Return true if any row changed since the last clearRowsDirty(). */
+    bool isAnyRowDirty() const { return this->isAnyDigitDirty(); }
+
+    /** Clear the dirty bits of all rows. */
+    void clearRowsDirty() { this->clearDigitsDirty(); }
+
+  private:
+    /**
+     * Shift `bits` by `x` columns away from column 0 if `x` is positive, or
+     * towards column 0 if negative. The caller ensures that `|x| < kWidth`.
+     */
+    static T_ROW shiftColumns(T_ROW bits, int8_t x) {
+      return (x >= 0)
+          ? (T_ROW) ((unsigned) bits << x)
+          : (T_ROW) (bits >> -x);
+    }
+};
+
+}
+
+#endif
@@ -51,6 +51,36 @@ const uint8_t kByteOrderSegmentHighDigitLow = kByteOrderElementHighGroupLow;
  */
 extern const uint8_t kDigitRemapArray8Hc595[8];
 
+namespace internal {
+
+/**
+ * Storage for the inverted remap array of Hc595Module. Hc595Module inherits
+ * from this class privately, so that the disabled specialization is optimized
+ * away by the empty base class optimization.
+ *
+ * @tparam T_DIGITS number of digits
+ * @tparam T_ENABLED false if kScanningOptionNoRemap is selected
+ */
+template <uint8_t T_DIGITS, bool T_ENABLED>
+class Hc595RemapArray {
+  protected:
+    /** Return the storage of the inverted remap array. */
+    uint8_t* remapArrayInverted() { return mRemapArrayInverted; }
+
+  private:
+    /** The inverted mapping, from physical to logical positions. */
+    uint8_t mRemapArrayInverted[T_DIGITS];
+};
+
+/** Specialization used when kScanningOptionNoRemap is selected. */
+template <uint8_t T_DIGITS>
+class Hc595RemapArray<T_DIGITS, false> {
+  protected:
+    uint8_t* remapArrayInverted() { return nullptr; }
+};
+
+} // namespace internal
+
 /**
  * An implementation of LedModule class that supports an LED module using 2
  * 74HC595 Shift Register chips. This is a convenience class that pairs together
@@ -65,25 +95,50 @@ extern const uint8_t kDigitRemapArray8Hc595[8];
  *    get brightness control.
  * @tparam T_CI class that provides access to Arduino clock functions (millis()
  *    and micros()). The default is ClockInterface.
+ * @tparam T_OPTIONS bit mask of the optional `kScanningOptionXxx` features of
+ *    ScanningModule (default: 0). Use kScanningOptionNoRemap to save T_DIGITS
+ *    bytes of RAM if no remapArray is passed into the constructor.
+ * @tparam T_PROBE (optional) instrumentation policy which times
+ *    renderFieldNow(), e.g. TimingProbe<> (default: NoTimingProbe)
+ * @tparam T_TIMER (optional) hardware timer which drives renderFieldNow()
+ *    after startTimer(), e.g. TimerOneInterface (default: NoTimerInterface)
  */
 template <
     typename T_SPII,
     uint8_t T_DIGITS,
     uint8_t T_SUBFIELDS = 1,
-    typename T_CI = ClockInterface
+    typename T_CI = ClockInterface,
+    uint16_t T_OPTIONS = 0,
+    typename T_PROBE = NoTimingProbe,
+    typename T_TIMER = NoTimerInterface
 >
-class Hc595Module : public ScanningModule<
-    LedMatrixDualHc595<T_SPII>,
-    T_DIGITS,
-    T_SUBFIELDS,
-    T_CI
-> {
+class Hc595Module :
+    public ScanningModule<
+        LedMatrixDualHc595<T_SPII>,
+        T_DIGITS,
+        T_SUBFIELDS,
+        T_CI,
+        T_OPTIONS,
+        Hc595Module<
+            T_SPII, T_DIGITS, T_SUBFIELDS, T_CI, T_OPTIONS, T_PROBE, T_TIMER>,
+        T_PROBE,
+        T_TIMER
+    >,
+    private internal::Hc595RemapArray<
+        T_DIGITS,
+        (T_OPTIONS & kScanningOptionNoRemap) == 0
+    > {
   private:
     using Super = ScanningModule<
         LedMatrixDualHc595<T_SPII>,
         T_DIGITS,
         T_SUBFIELDS,
-        T_CI
+        T_CI,
+        T_OPTIONS,
+        Hc595Module<
+            T_SPII, T_DIGITS, T_SUBFIELDS, T_CI, T_OPTIONS, T_PROBE, T_TIMER>,
+        T_PROBE,
+        T_TIMER
     >;
 
   public:
@@ -103,7 +158,7 @@ class Hc595Module : public ScanningModule<
      * @param remapArray (optional, nullable) a mapping from the logical digit
      *    positions to their physical positions. For example, the 8-digit LED
      *    modules from diymore.cc have the left 4 and right 4 LED digits
-     *    swapped.
+     *    swapped. Ignored if kScanningOptionNoRemap is selected.
      */
     Hc595Module(
         const T_SPII& spiInterface,
@@ -113,18 +168,19 @@ class Hc595Module : public ScanningModule<
         uint8_t byteOrder,
         const uint8_t* remapArray = nullptr
     ) :
-        Super(mLedMatrix, framesPerSecond),
+        Super(framesPerSecond),
         mLedMatrix(
             spiInterface,
             segmentOnPattern /*elementOnPattern*/,
             digitOnPattern /*groupOnPattern*/,
             byteOrder,
-            remapArray ? mRemapArrayInverted : nullptr
+            remapArray ? this->remapArrayInverted() : nullptr
         )
     {
       // LedMatrixDualHc595 needs the inverted mapping.
-      if (remapArray) {
-        internal::invertRemapArray(mRemapArrayInverted, remapArray, T_DIGITS);
+      uint8_t* remapArrayInverted = this->remapArrayInverted();
+      if (remapArray && remapArrayInverted) {
+        internal::invertRemapArray(remapArrayInverted, remapArray, T_DIGITS);
       }
     }
 
@@ -139,10 +195,10 @@ class Hc595Module : public ScanningModule<
     }
 
   private:
-    LedMatrixDualHc595<T_SPII> mLedMatrix;
+    // ScanningModule accesses mLedMatrix directly.
+    friend Super;
 
-    /** The inverted mapping, from physical to logical positions. */
-    uint8_t mRemapArrayInverted[T_DIGITS];
+    LedMatrixDualHc595<T_SPII> mLedMatrix;
 };
 
 } // ace_segment
@@ -28,12 +28,25 @@ SOFTWARE.
 #include <stdint.h>
 #include <string.h> // memset()
 #include "../LedModule.h"
+#include "../TimingProbe.h"
+#include "../ShadowBuffer.h"
 
 class Ht16k33ModuleTest_patternForChipPos_colonDisabled;
 class Ht16k33ModuleTest_patternForChipPos_colonEnabled;
 
 namespace ace_segment {
 
+namespace internal {
+
+/**
+ * Map of the 5 physical COM lines of the 4-digit HT16K33 module to the logical
+ * digit which determines its pattern. COM2 holds the colon, which is taken
+ * from the decimal point of digit 1.
+ */
+extern const uint8_t kComRemapArrayHt16k33[5];
+
+} // internal
+
 /**
  * An implementation of LedModule using the HT16K33 chip. The chip uses I2C
  * for communication.
@@ -56,14 +69,54 @@ namespace ace_segment {
  * enableColon() method. You can display the time of a clock (`hh:mm`), then
  * display a normal number with a decimal point (`xx.yy`).
  *
+ * With `T_PATTERN = uint16_t`, this class supports instead the 14-segment
+ * alphanumeric modules (e.g. https://www.adafruit.com/product/1911), whose
+ * digits are wired to COM0 to COM{T_DIGITS-1} in order, with the 16 bits of
+ * each pattern on ROW0-ROW15. There is no colon, and enableColon() has no
+ * effect.
+ *
  * @tparam T_WIREI the class that wraps the I2C Wire interface (one of
  *    TwoWireInterface, SimpleWireInterface of SimpleWireFastInterface)
  * @tparam T_DIGITS number of logical digits in the module. Currently this
  *    should always be set to 4 because it is designed to support the 4-digit
  *    LED modules found on Adafruit, Amazon or eBay.
+ * @tparam T_SHADOW keep a copy of the bytes last sent to the chip, so that
+ *    flush() transmits only the COM lines which differ (default: false)
+ * @tparam T_PROBE (optional) instrumentation policy which times flush() and
+ *    flushDirty(), e.g. TimingProbe<> (default: NoTimingProbe)
+ * @tparam T_PATTERN (optional) type of the segment pattern of one digit,
+ *    `uint8_t` for 7-segment modules (default), or `uint16_t` for 14-segment
+ *    modules
  */
-template <typename T_WIREI, uint8_t T_DIGITS>
-class Ht16k33Module : public LedModule {
+template <
+    typename T_WIREI,
+    uint8_t T_DIGITS,
+    bool T_SHADOW = false,
+    typename T_PROBE = NoTimingProbe,
+    typename T_PATTERN = uint8_t
+>
+class Ht16k33Module :
+    public BasicLedModule<T_PATTERN>,
+    private T_PROBE,
+    private internal::ShadowBuffer<
+        (sizeof(T_PATTERN) > 1) ? 2 * T_DIGITS + 1 : T_DIGITS + 2,
+        T_SHADOW> {
+  private:
+    using Super = BasicLedModule<T_PATTERN>;
+
+    /** True for the 14-segment modules, which have one COM line per digit. */
+    static const bool kWide = sizeof(T_PATTERN) > 1;
+
+    /** Number of COM lines. */
+    static const uint8_t kNumComs = kWide ? T_DIGITS : T_DIGITS + 1;
+
+    /**
+     * Position of the brightness command in the shadow copy, after the COM
+     * lines. A 16-bit COM line takes 2 positions.
+     */
+    static const uint8_t kBrightnessShadowPos =
+        kWide ? 2 * T_DIGITS : T_DIGITS + 1;
+
   public:
     /**
      * Constructor.
@@ -79,7 +132,7 @@ class Ht16k33Module : public LedModule {
         uint8_t addr,
         bool enableColon = false
     ) :
-        LedModule(mPatterns, T_DIGITS),
+        Super(mPatterns, T_DIGITS),
         mWireInterface(wireInterface),
         mAddr(addr),
         mEnableColon(enableColon)
@@ -90,9 +143,10 @@ class Ht16k33Module : public LedModule {
     //-----------------------------------------------------------------------
 
     void begin() {
-      LedModule::begin();
+      Super::begin();
 
-      memset(mPatterns, 0, T_DIGITS);
+      memset(mPatterns, 0, sizeof(mPatterns));
+      this->invalidateShadow();
       writeCommand(kSystemOn);
       writeCommand(kDisplayOn);
     }
@@ -101,7 +155,7 @@ class Ht16k33Module : public LedModule {
       writeCommand(kDisplayOff);
       writeCommand(kSystemOff);
 
-      LedModule::end();
+      Super::end();
     }
 
     /**
@@ -115,6 +169,9 @@ class Ht16k33Module : public LedModule {
      */
     void enableColon(bool enable) {
       mEnableColon = enable;
+      if (! kWide) {
+        this->setDigitDirty(1); // COM1 and COM2 depend on the colon
+      }
     }
 
     //-----------------------------------------------------------------------
@@ -123,9 +180,15 @@ class Ht16k33Module : public LedModule {
 
     /** Return true if flushing required. */
     bool isFlushRequired() const {
-      return isAnyDigitDirty() || isBrightnessDirty();
+      return this->isAnyDigitDirty() || this->isBrightnessDirty();
     }
 
+    /** Return the T_PROBE which times the flush methods. */
+    T_PROBE& getTimingProbe() { return *this; }
+
+    /** Return the T_PROBE which times the flush methods. */
+    const T_PROBE& getTimingProbe() const { return *this; }
+
     /**
      * Send segment patterns of all digits. Using the default 100kHz speed of
      * Wire, this takes about 1.2 millis to send 4 digits.
@@ -147,24 +210,101 @@ class Ht16k33Module : public LedModule {
      *
      * The isFlushRequired() method can be used to optimize the number of calls
      * to flush(), but often it is not necessary.
+     *
+     * If T_SHADOW is enabled, only the span of COM lines between the first and
+     * last lines which differ from the chip is sent, and the brightness is
+     * sent only if it changed.
      */
     void flush() {
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
+      // Find the span of the 5 physical digit lines which must be sent. Without
+      // the shadow copy, this is always all of them.
+      uint8_t beginPos = kNumComs;
+      uint8_t endPos = 0;
+      for (uint8_t chipPos = 0; chipPos < kNumComs; ++chipPos) {
+        T_PATTERN pattern = patternForChipPos(chipPos);
+        if (isComShadowDifferent(chipPos, pattern)) {
+          if (beginPos == kNumComs) beginPos = chipPos;
+          endPos = chipPos + 1;
+        }
+      }
+
+      uint8_t brightnessCmd = this->getBrightness() | kBrightness;
+      bool isBrightnessChanged =
+          this->updateShadow(kBrightnessShadowPos, brightnessCmd);
+
       // Write digits.
-      mWireInterface.beginTransmission(mAddr);
-      mWireInterface.write(0x00); // start at position 0
-      // Loop over the 5 physical digit lines of this module.
-      for (uint8_t chipPos = 0; chipPos < T_DIGITS + 1; ++chipPos) {
-        uint8_t pattern = patternForChipPos(chipPos, mPatterns, mEnableColon);
-        mWireInterface.write(pattern); // ROW0-ROW7
-        mWireInterface.write(0); // ROW8-ROW15 unused
+      if (beginPos < endPos) {
+        mWireInterface.beginTransmission(mAddr);
+        mWireInterface.write(beginPos * 2); // 2 bytes per COM line
+        for (uint8_t chipPos = beginPos; chipPos < endPos; ++chipPos) {
+          writeCom(chipPos, patternForChipPos(chipPos));
+        }
+        // HT16K33 supports repeated START, but the bus must be released with a
+        // STOP if the brightness command does not follow.
+        mWireInterface.endTransmission(! isBrightnessChanged);
       }
-      mWireInterface.endTransmission(false); // HT16K33 supports repeated START
 
       // Write brightness.
-      writeCommand(getBrightness() | kBrightness);
+      if (isBrightnessChanged) {
+        writeCommand(brightnessCmd);
+      }
+
+      this->validateShadow();
+      this->clearDigitsDirty();
+      this->clearBrightnessDirty();
+    }
+
+    /**
+     * Send only the dirty COM lines, using one auto-increment burst for each
+     * run of consecutive dirty COM lines, followed by the brightness if it is
+     * dirty. If T_SHADOW is enabled, dirty digits whose COM lines the chip
+     * already holds are skipped. The first call after begin() sends
+     * everything through flush(), so that the shadow copy becomes valid.
+     */
+    void flushDirty() {
+      if (! this->isShadowValid()) {
+        flush();
+        return;
+      }
+
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
+      clearShadowedDigitsDirty();
+
+      bool isBrightnessChanged = false;
+      uint8_t brightnessCmd = this->getBrightness() | kBrightness;
+      if (this->isBrightnessDirty()) {
+        isBrightnessChanged =
+            this->updateShadow(kBrightnessShadowPos, brightnessCmd);
+      }
+
+      const uint8_t* const remapArray =
+          kWide ? nullptr : internal::kComRemapArrayHt16k33;
+      uint8_t beginPos = 0;
+      uint8_t endPos = this->nextDirtyRun(beginPos, kNumComs, remapArray);
+      while (beginPos < endPos) {
+        mWireInterface.beginTransmission(mAddr);
+        mWireInterface.write(beginPos * 2); // 2 bytes per COM line
+        for (uint8_t chipPos = beginPos; chipPos < endPos; ++chipPos) {
+          writeCom(chipPos, patternForChipPos(chipPos));
+        }
 
-      clearDigitsDirty();
-      clearBrightnessDirty();
+        // Use a repeated START if another transmission follows, otherwise
+        // release the bus with a STOP.
+        beginPos = endPos;
+        endPos = this->nextDirtyRun(beginPos, kNumComs, remapArray);
+        bool isLast = (beginPos == endPos);
+        mWireInterface.endTransmission(isLast && ! isBrightnessChanged);
+      }
+
+      if (isBrightnessChanged) {
+        writeCommand(brightnessCmd);
+      }
+
+      this->clearDigitsDirty();
+      this->clearBrightnessDirty();
     }
 
   private:
@@ -178,6 +318,60 @@ class Ht16k33Module : public LedModule {
       mWireInterface.endTransmission();
     }
 
+    /**
+     * Write the pattern of the COM line at `chipPos` as its ROW0-ROW7 and
+     * ROW8-ROW15 bytes, and record them in the shadow copy. ROW8-ROW15 are
+     * unused by the 7-segment modules.
+     */
+    void writeCom(uint8_t chipPos, T_PATTERN pattern) {
+      if (kWide) {
+        this->updateShadow(2 * chipPos, (uint8_t) pattern);
+        this->updateShadow(2 * chipPos + 1, (uint8_t) (pattern >> 8));
+      } else {
+        this->updateShadow(chipPos, (uint8_t) pattern);
+      }
+      mWireInterface.write((uint8_t) pattern); // ROW0-ROW7
+      mWireInterface.write((uint8_t) (pattern >> 8)); // ROW8-ROW15
+    }
+
+    /** Return true if `pattern` differs from the shadow of COM `chipPos`. */
+    bool isComShadowDifferent(uint8_t chipPos, T_PATTERN pattern) const {
+      if (kWide) {
+        return this->isShadowDifferent(2 * chipPos, (uint8_t) pattern)
+            || this->isShadowDifferent(
+                2 * chipPos + 1, (uint8_t) (pattern >> 8));
+      } else {
+        return this->isShadowDifferent(chipPos, (uint8_t) pattern);
+      }
+    }
+
+    /**
+     * Clear the dirty bits of the digits whose COM lines all match the shadow
+     * copy of the chip. Does nothing if T_SHADOW is disabled.
+     */
+    void clearShadowedDigitsDirty() {
+      if (! T_SHADOW) return;
+      uint8_t differentDigits = 0; // bit mask of the 4 digits
+      for (uint8_t chipPos = 0; chipPos < kNumComs; ++chipPos) {
+        T_PATTERN pattern = patternForChipPos(chipPos);
+        if (isComShadowDifferent(chipPos, pattern)) {
+          differentDigits |= 1 << (kWide
+              ? chipPos : internal::kComRemapArrayHt16k33[chipPos]);
+        }
+      }
+      for (uint8_t pos = 0; pos < T_DIGITS; ++pos) {
+        if (! (differentDigits & (1 << pos))) this->clearDigitDirty(pos);
+      }
+    }
+
+    /** Return the pattern of the COM line at `chipPos`. */
+    T_PATTERN patternForChipPos(uint8_t chipPos) const {
+      return kWide
+          ? mPatterns[chipPos]
+          : (T_PATTERN) patternForChipPos(
+              chipPos, (const uint8_t*) mPatterns, mEnableColon);
+    }
+
     /**
      * Return the segment pattern appropriate for the given physical digit
      * position (COM{N}}. This function is static for unit testing purposes.
@@ -230,7 +424,7 @@ class Ht16k33Module : public LedModule {
     uint8_t const mAddr;
 
     /** Pattern for each digit. */
-    uint8_t mPatterns[T_DIGITS];
+    T_PATTERN mPatterns[T_DIGITS];
 
     /** Enable colon. */
     bool mEnableColon;
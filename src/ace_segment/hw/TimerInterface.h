@@ -0,0 +1,124 @@
+/*
+MIT License
+
+Copyright (c) 2021 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_TIMER_INTERFACE_H
+#define ACE_SEGMENT_TIMER_INTERFACE_H
+
+#include <stdint.h>
+
+namespace ace_segment {
+
+/**
+ * The default T_TIMER of ScanningModule, for applications which call
+ * renderFieldNow() or renderFieldWhenReady() themselves. All methods are
+ * empty, so ScanningModule::startTimer() does nothing.
+ *
+ * A T_TIMER is a utility class (all methods are static), like ClockInterface,
+ * which owns one hardware timer and calls a single callback from its
+ * interrupt. It provides:
+ *
+ *  * `attachInterrupt(callback, context, micros)`: call `callback(context)`
+ *    every `micros`, starting `micros` from now
+ *  * `setPeriodMicros(micros)`: when called from the callback, set the
+ *    interval between the current interrupt and the next one
+ *  * `detachInterrupt()`: stop calling the callback
+ */
+class NoTimerInterface {
+  public:
+    /** Type of the function called from the timer interrupt. */
+    typedef void (*Callback)(void* context);
+
+    static void attachInterrupt(
+        Callback /*callback*/, void* /*context*/, uint16_t /*micros*/) {}
+
+    static void setPeriodMicros(uint16_t /*micros*/) {}
+
+    static void detachInterrupt() {}
+};
+
+/**
+ * A T_TIMER which uses the Timer1 object of the TimerOne library
+ * (https://github.com/PaulStoffregen/TimerOne). The library is not a
+ * dependency of AceSegment, so the application includes <TimerOne.h> and
+ * passes the class and the instance as template parameters:
+ *
+ * @code
+ * #include <TimerOne.h>
+ * using TimerInterface = TimerOneInterface<TimerOne, Timer1>;
+ * @endcode
+ *
+ * The period is written to the timer only if it changed, because
+ * `TimerOne::setPeriod()` recomputes the prescaler, which is slow compared to
+ * the rest of the interrupt handler.
+ *
+ * @tparam T_TIMER_ONE the TimerOne class
+ * @tparam T_INSTANCE the instance of T_TIMER_ONE, usually `Timer1`
+ */
+template <typename T_TIMER_ONE, T_TIMER_ONE& T_INSTANCE>
+class TimerOneInterface {
+  public:
+    /** Type of the function called from the timer interrupt. */
+    typedef void (*Callback)(void* context);
+
+    static void attachInterrupt(Callback callback, void* context,
+        uint16_t micros) {
+      sCallback = callback;
+      sContext = context;
+      sPeriodMicros = micros;
+      T_INSTANCE.initialize(micros);
+      T_INSTANCE.attachInterrupt(isr);
+    }
+
+    static void setPeriodMicros(uint16_t micros) {
+      if (micros == sPeriodMicros) return;
+      sPeriodMicros = micros;
+      T_INSTANCE.setPeriod(micros);
+    }
+
+    static void detachInterrupt() {
+      T_INSTANCE.detachInterrupt();
+    }
+
+  private:
+    /** The function given to T_INSTANCE, which has no context parameter. */
+    static void isr() { sCallback(sContext); }
+
+    static Callback sCallback;
+    static void* sContext;
+    static uint16_t sPeriodMicros;
+};
+
+template <typename T_TIMER_ONE, T_TIMER_ONE& T_INSTANCE>
+typename TimerOneInterface<T_TIMER_ONE, T_INSTANCE>::Callback
+TimerOneInterface<T_TIMER_ONE, T_INSTANCE>::sCallback;
+
+template <typename T_TIMER_ONE, T_TIMER_ONE& T_INSTANCE>
+void* TimerOneInterface<T_TIMER_ONE, T_INSTANCE>::sContext;
+
+template <typename T_TIMER_ONE, T_TIMER_ONE& T_INSTANCE>
+uint16_t TimerOneInterface<T_TIMER_ONE, T_INSTANCE>::sPeriodMicros;
+
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef ACE_SEGMENT_BARRIER_H
+#define ACE_SEGMENT_BARRIER_H
+
+namespace ace_segment {
+namespace internal {
+
+/**
+ * Prevent the compiler (and the processor, on platforms with weakly ordered
+ * memory) from moving memory accesses across this point. Used to publish data
+ * from the main loop to an interrupt handler (or vice versa) through a
+ * `volatile` flag or counter: the data must be written before the flag, and
+ * read after it.
+ *
+ * On AVR, the processor does not reorder memory accesses, so a compiler
+ * barrier is sufficient and costs nothing at runtime.
+ */
+inline void memoryBarrier() {
+#if defined(ARDUINO_ARCH_AVR)
+  __asm__ __volatile__ ("" ::: "memory");
+#else
+  __sync_synchronize();
+#endif
+}
+
+} // namespace internal
+} // namespace ace_segment
+
+#endif
@@ -46,26 +46,47 @@ namespace ace_segment {
  *    and micros()). The default is ClockInterface.
  * @tparam T_GPIOI (optional) interface to GPIO functions,
  *    default GpioInterface (note: 'GPI' is already taken on ESP8266)
+ * @tparam T_OPTIONS bit mask of the optional `kScanningOptionXxx` features of
+ *    ScanningModule (default: 0)
+ * @tparam T_PROBE (optional) instrumentation policy which times
+ *    renderFieldNow(), e.g. TimingProbe<> (default: NoTimingProbe)
+ * @tparam T_TIMER (optional) hardware timer which drives renderFieldNow()
+ *    after startTimer(), e.g. TimerOneInterface (default: NoTimerInterface)
  */
 template <
     typename T_SPII,
     uint8_t T_DIGITS,
     uint8_t T_SUBFIELDS = 1,
     typename T_CI = ClockInterface,
-    typename T_GPIOI = GpioInterface
+    typename T_GPIOI = GpioInterface,
+    uint16_t T_OPTIONS = 0,
+    typename T_PROBE = NoTimingProbe,
+    typename T_TIMER = NoTimerInterface
 >
 class HybridModule : public ScanningModule<
     LedMatrixSingleHc595<T_SPII, T_GPIOI>,
     T_DIGITS,
     T_SUBFIELDS,
-    T_CI
+    T_CI,
+    T_OPTIONS,
+    HybridModule<
+        T_SPII, T_DIGITS, T_SUBFIELDS, T_CI, T_GPIOI, T_OPTIONS, T_PROBE,
+        T_TIMER>,
+    T_PROBE,
+    T_TIMER
 > {
   private:
     using Super = ScanningModule<
         LedMatrixSingleHc595<T_SPII, T_GPIOI>,
         T_DIGITS,
         T_SUBFIELDS,
-        T_CI
+        T_CI,
+        T_OPTIONS,
+        HybridModule<
+            T_SPII, T_DIGITS, T_SUBFIELDS, T_CI, T_GPIOI, T_OPTIONS, T_PROBE,
+        T_TIMER>,
+        T_PROBE,
+        T_TIMER
     >;
 
   public:
@@ -76,7 +97,7 @@ class HybridModule : public ScanningModule<
         uint8_t framesPerSecond,
         const uint8_t* digitPins
     ) :
-        Super(mLedMatrix, framesPerSecond),
+        Super(framesPerSecond),
         mLedMatrix(
             spiInterface,
             segmentOnPattern /*elementOnPattern*/,
@@ -97,6 +118,9 @@ class HybridModule : public ScanningModule<
     }
 
   private:
+    // ScanningModule accesses mLedMatrix directly.
+    friend Super;
+
     LedMatrixSingleHc595<T_SPII, T_GPIOI> mLedMatrix;
 };
 
@@ -28,6 +28,8 @@ SOFTWARE.
 #include <stdint.h>
 #include <string.h> // memset()
 #include "../LedModule.h"
+#include "../TimingProbe.h"
+#include "../ShadowBuffer.h"
 
 namespace ace_segment {
 
@@ -102,9 +104,21 @@ extern const uint8_t kDigitRemapArray8Max7219[8];
  *    classes in the AceSPI library: SimpleSpiInterface, SimpleSpiFastInterface,
  *    HardSpiInterface, HardSpiFastInterface.
  * @tparam T_DIGITS number of digits in the module
+ * @tparam T_SHADOW keep a copy of the bytes last sent to the chip, so that
+ *    flush() transmits only the registers which differ (default: false)
+ * @tparam T_PROBE (optional) instrumentation policy which times flush(), e.g.
+ *    TimingProbe<> (default: NoTimingProbe)
  */
-template <typename T_SPII, uint8_t T_DIGITS>
-class Max7219Module : public LedModule {
+template <
+    typename T_SPII,
+    uint8_t T_DIGITS,
+    bool T_SHADOW = false,
+    typename T_PROBE = NoTimingProbe
+>
+class Max7219Module :
+    public LedModule,
+    private T_PROBE,
+    private internal::ShadowBuffer<T_DIGITS + 1, T_SHADOW> {
   public:
     /**
      * Constructor.
@@ -129,6 +143,7 @@ class Max7219Module : public LedModule {
       LedModule::begin();
 
       memset(mPatterns, 0, T_DIGITS);
+      this->invalidateShadow();
 
       // Set to a non-zero value to avoid using uninitialized value.
       setBrightness(1);
@@ -157,6 +172,12 @@ class Max7219Module : public LedModule {
       return isAnyDigitDirty() || isBrightnessDirty();
     }
 
+    /** Return the T_PROBE which times the flush methods. */
+    T_PROBE& getTimingProbe() { return *this; }
+
+    /** Return the T_PROBE which times the flush methods. */
+    const T_PROBE& getTimingProbe() const { return *this; }
+
     /**
      * Send segment patterns of all digits. For a rough idea of how long
      * this function takes, here are the numbers on a 16 MHz AVR:
@@ -167,8 +188,13 @@ class Max7219Module : public LedModule {
      *
      * The isFlushRequired() method can be used to optimize the number of calls
      * to flush(), but often it is not necessary.
+     *
+     * If T_SHADOW is enabled, only the digit and intensity registers whose
+     * values differ from the chip are sent.
      */
     void flush() {
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
       for (uint8_t chipPos = 0; chipPos < T_DIGITS; ++chipPos) {
         // Remap the logical position used by the controller to the actual
         // position. For example, if the controller digit 0 appears at physical
@@ -177,11 +203,16 @@ class Max7219Module : public LedModule {
         uint8_t physicalPos = remapLogicalToPhysical(chipPos);
         uint8_t convertedPattern = internal::convertPatternMax7219(
             mPatterns[physicalPos]);
-        mSpiInterface.send16(chipPos + 1, convertedPattern);
+        if (this->updateShadow(chipPos, convertedPattern)) {
+          mSpiInterface.send16(chipPos + 1, convertedPattern);
+        }
       }
 
-      mSpiInterface.send16(kRegisterIntensity, getBrightness());
+      if (this->updateShadow(T_DIGITS, getBrightness())) {
+        mSpiInterface.send16(kRegisterIntensity, getBrightness());
+      }
 
+      this->validateShadow();
       clearDigitsDirty();
       clearBrightnessDirty();
     }
@@ -39,15 +39,21 @@ namespace ace_segment {
  *
  * @tparam T_GPIOI (optional) class that provides access to the GPIO pins,
  *    default is GpioInterface (note: 'GPI' is already taken on ESP8266)
+ * @tparam T_PATTERN (optional) type of the element pattern, `uint8_t`
+ *    (default) for at most 8 element pins, or `uint16_t` for up to 16, e.g.
+ *    14-segment digits, or more than 8 digits wired as the elements for
+ *    kScanningOptionSegmentMajor
  */
-template <typename T_GPIOI = GpioInterface>
+template <typename T_GPIOI = GpioInterface, typename T_PATTERN = uint8_t>
 class LedMatrixDirect : public LedMatrixBase {
   public:
     /**
      * Constructor.
      * @param elementOnPattern bit pattern that turns on the elements (segments)
      * @param groupOnpattern bit pattern that turns on the groups (digits)
-     * @param numElements number of LED segments, almost always 8
+     * @param numElements number of LED segments, almost always 8, or the
+     *    number of digits if the digits are the elements. At most 8 with the
+     *    default `T_PATTERN`, or 16 with `uint16_t`.
      * @param elementPins pointer to array of 'numElements' pin numbers
      * @param numGroups number of LED groups (digits)
      * @param groupPins pointer to array of 'numGroups' pin numbers
@@ -99,7 +105,7 @@ class LedMatrixDirect : public LedMatrixBase {
       }
     }
 
-    void draw(uint8_t group, uint8_t elementPattern) const {
+    void draw(uint8_t group, T_PATTERN elementPattern) const {
       if (group != mPrevGroup) {
         disableGroup(mPrevGroup);
       }
@@ -130,7 +136,7 @@ class LedMatrixDirect : public LedMatrixBase {
     friend class ::LedMatrixDirectTest_drawElements;
 
     /** Send the pattern to the element pins. */
-    void drawElements(uint8_t pattern) const {
+    void drawElements(T_PATTERN pattern) const {
       for (uint8_t element = 0; element < mNumElements; element++) {
         writeElementPin(element, pattern);
         pattern >>= 1;
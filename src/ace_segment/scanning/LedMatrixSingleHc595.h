@@ -43,13 +43,24 @@ namespace ace_segment {
  *   dataPin/D11/MOSI -- DS (Phillips) / SER (TI) / Pin 14
  *   clockPin/D13/SCK -- SH_CP (Phillips) / SRCK (TI) / Pin 11 (rising)
  *
+ * For 14-segment or 16-segment digits, with `T_PATTERN = uint16_t`, the
+ * segment pins are attached to 2 daisy chained 74HC595 chips which receive
+ * the 16-bit element pattern in a single SPI transfer. Bits 0-7 go to the
+ * chip which is connected directly to the data pin, and bits 8-15 to the
+ * second chip. Both chips use the same elementOnPattern.
+ *
  * @tparam T_SPII class that implements the SPI interface, usually one of the
  *    classes in the AceSPI library: SimpleSpiInterface, SimpleSpiFastInterface,
  *    HardSpiInterface, HardSpiFastInterface.
  * @tparam T_GPIOI (optional) interface to GPIO functions,
  *    default GpioInterface (note: 'GPI' is already taken on ESP8266)
+ * @tparam T_PATTERN (optional) type of the element pattern, `uint8_t`
+ *    (default) for one 74HC595 chip, or `uint16_t` for 2 chips
  */
-template <typename T_SPII, typename T_GPIOI = GpioInterface>
+template <
+    typename T_SPII,
+    typename T_GPIOI = GpioInterface,
+    typename T_PATTERN = uint8_t>
 class LedMatrixSingleHc595 : public LedMatrixBase {
   public:
     /**
@@ -91,7 +102,7 @@ class LedMatrixSingleHc595 : public LedMatrixBase {
       }
     }
 
-    void draw(uint8_t group, uint8_t elementPattern) const {
+    void draw(uint8_t group, T_PATTERN elementPattern) const {
       if (group != mPrevGroup) {
         disableGroup(mPrevGroup);
       }
@@ -122,9 +133,14 @@ class LedMatrixSingleHc595 : public LedMatrixBase {
     friend class ::LedMatrixSingleHc595Test_drawElements;
 
     /** Send the pattern to the element pins. */
-    void drawElements(uint8_t pattern) const {
-      uint8_t actualPattern = pattern ^ mElementXorMask;
-      mSpiInterface.send8(actualPattern);
+    void drawElements(T_PATTERN pattern) const {
+      if (sizeof(T_PATTERN) == 1) {
+        uint8_t actualPattern = pattern ^ mElementXorMask;
+        mSpiInterface.send8(actualPattern);
+      } else {
+        uint16_t xorMask = (uint16_t) mElementXorMask << 8 | mElementXorMask;
+        mSpiInterface.send16(pattern ^ xorMask);
+      }
     }
 
     /** Write bit 0 of output to group pin. */
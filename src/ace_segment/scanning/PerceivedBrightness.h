@@ -0,0 +1,153 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_PERCEIVED_BRIGHTNESS_H
+#define ACE_SEGMENT_PERCEIVED_BRIGHTNESS_H
+
+#include <stdint.h>
+#include <Arduino.h> // PROGMEM, pgm_read_byte()
+
+namespace ace_segment {
+namespace internal {
+
+/**
+ * Return the relative luminance, from 0.0 to 1.0, of the given CIE 1931
+ * lightness L*, from 0 to 100. Lightness is roughly proportional to the
+ * perceived brightness, and follows a cube law above L* = 8.
+ */
+constexpr double cieLuminance(double lightness) {
+  return (lightness <= 8.0)
+      ? lightness / 903.3
+      : ((lightness + 16.0) / 116.0)
+          * ((lightness + 16.0) / 116.0)
+          * ((lightness + 16.0) / 116.0);
+}
+
+/**
+ * Round the given brightness to the nearest integer, but at least 1, so that
+ * a non-zero level is never turned off.
+ */
+constexpr uint8_t roundBrightness(double brightness) {
+  return (brightness < 1.0) ? 1 : (uint8_t) (brightness + 0.5);
+}
+
+/**
+ * Return the brightness, from 0 to maxBrightness, which looks like `level`
+ * out of `numLevels` equally spaced perceptual levels. Level 0 is off.
+ */
+constexpr uint8_t perceivedToBrightness(
+    uint8_t level, uint8_t numLevels, uint8_t maxBrightness) {
+  return (level == 0)
+      ? 0
+      : roundBrightness(
+          cieLuminance(100.0 * level / (numLevels - 1)) * maxBrightness);
+}
+
+/** A list of indexes, because std::integer_sequence requires C++14. */
+template <uint8_t... T_INDEXES>
+struct IndexList {};
+
+/** Create the IndexList of [0, T_SIZE). */
+template <uint8_t T_SIZE, uint8_t... T_INDEXES>
+struct MakeIndexList : MakeIndexList<T_SIZE - 1, T_SIZE - 1, T_INDEXES...> {};
+
+template <uint8_t... T_INDEXES>
+struct MakeIndexList<0, T_INDEXES...> {
+  typedef IndexList<T_INDEXES...> Type;
+};
+
+/** The table of PerceivedBrightness, generated by the compiler in flash. */
+template <uint8_t T_LEVELS, uint8_t T_MAX_BRIGHTNESS, typename T_INDEX_LIST>
+struct PerceivedBrightnessTable;
+
+template <uint8_t T_LEVELS, uint8_t T_MAX_BRIGHTNESS, uint8_t... T_INDEXES>
+struct PerceivedBrightnessTable<
+    T_LEVELS, T_MAX_BRIGHTNESS, IndexList<T_INDEXES...>> {
+  static const uint8_t kBrightnesses[T_LEVELS] PROGMEM;
+};
+
+template <uint8_t T_LEVELS, uint8_t T_MAX_BRIGHTNESS, uint8_t... T_INDEXES>
+const uint8_t PerceivedBrightnessTable<
+    T_LEVELS, T_MAX_BRIGHTNESS, IndexList<T_INDEXES...>
+>::kBrightnesses[T_LEVELS] PROGMEM = {
+  perceivedToBrightness(T_INDEXES, T_LEVELS, T_MAX_BRIGHTNESS)...
+};
+
+} // namespace internal
+
+/**
+ * A table, computed at compile time and stored in flash, which maps T_LEVELS
+ * perceptual brightness levels onto the raw brightness of
+ * ScanningModule::setBrightness() and setBrightnessAt(), from 0 to
+ * T_MAX_BRIGHTNESS. The raw brightness is the duty cycle of the LED, but the
+ * eye responds roughly logarithmically to it, so that the upper half of a
+ * linear scale looks almost the same. The table follows the CIE 1931
+ * lightness curve instead, so that each step looks equally large.
+ *
+ * The raw scale must be several times finer than T_LEVELS, otherwise the
+ * lower levels collapse into the same raw brightness. The cheapest way to get
+ * a fine scale is kScanningOptionBitAngle, which gives 63 raw levels with 6
+ * subfields per digit, instead of the 63 subfields needed by PWM. For example:
+ *
+ * @code
+ * using Module = ScanningModule<
+ *     LedMatrix, 4, 6, ClockInterface, kScanningOptionBitAngle>;
+ * using Brightness = PerceivedBrightness<8, Module::kMaxBrightness>;
+ * ledModule.setBrightness(Brightness::toBrightness(level));
+ * @endcode
+ *
+ * Each instantiation uses T_LEVELS bytes of flash, and no RAM.
+ *
+ * @tparam T_LEVELS number of perceptual levels, including 0 which is off
+ * @tparam T_MAX_BRIGHTNESS the raw brightness of the highest level, usually
+ *    ScanningModule::kMaxBrightness
+ */
+template <uint8_t T_LEVELS, uint8_t T_MAX_BRIGHTNESS>
+class PerceivedBrightness {
+    static_assert(T_LEVELS >= 2, "T_LEVELS must be at least 2");
+
+  public:
+    /** Number of perceptual levels. */
+    static const uint8_t kNumLevels = T_LEVELS;
+
+    /**
+     * Return the raw brightness of the given perceptual level. Levels greater
+     * than T_LEVELS - 1 are clamped.
+     */
+    static uint8_t toBrightness(uint8_t level) {
+      if (level >= T_LEVELS) level = T_LEVELS - 1;
+      return pgm_read_byte(&Table::kBrightnesses[level]);
+    }
+
+  private:
+    typedef internal::PerceivedBrightnessTable<
+        T_LEVELS,
+        T_MAX_BRIGHTNESS,
+        typename internal::MakeIndexList<T_LEVELS>::Type
+    > Table;
+};
+
+} // namespace ace_segment
+
+#endif
@@ -0,0 +1,213 @@
+/*
+MIT License
+
+Copyright (c) 2021 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_SCANNING_GROUP_H
+#define ACE_SEGMENT_SCANNING_GROUP_H
+
+#include <stdint.h>
+#include <AceCommon.h> // incrementMod()
+#include "../hw/ClockInterface.h" // ClockInterface
+#include "../hw/TimerInterface.h" // NoTimerInterface
+
+class ScanningGroupTest_renderFieldNow;
+
+namespace ace_segment {
+
+/**
+ * Multiplex T_SIZE scanning modules (ScanningModule, DirectModule,
+ * HybridModule, Hc595Module, ...) from a single timer interrupt or polling
+ * loop. Each call to renderFieldNow() renders one field of one module, taking
+ * the modules in turn, so that the cost of a tick is a single draw() of a
+ * single module, instead of one draw() per module. Each field of a module
+ * stays on while the other modules render theirs, so a module renders its
+ * fields at 1/T_SIZE of the rate of the group, and the group must be ticked
+ * T_SIZE times as often as one module. getMicrosPerField() returns that
+ * period.
+ *
+ * The modules are expected to have the same number of fields per second, and
+ * fields of equal durations, i.e. they must not use kScanningOptionBitAngle
+ * or kScanningOptionSkipBlank. Their begin() must be called before the
+ * begin() of the group, and they must not be rendered by anything else.
+ *
+ * Each module drives its own digit and segment lines. Modules which share
+ * the segment lines, e.g. several LED modules on the segment 74HC595 of a
+ * HybridModule, cannot be grouped, because a digit of one module would
+ * display the segments of another. Instead, declare a single HybridModule
+ * with the digit pins of all of them, which scans them as one wider module
+ * at the same cost per field.
+ *
+ * @code
+ * HybridModule<...> moduleA(...);
+ * Hc595Module<...> moduleB(...);
+ * ScanningGroup<2> group;
+ *
+ * void setup() {
+ *   moduleA.begin();
+ *   moduleB.begin();
+ *   group.setModuleAt(0, moduleA);
+ *   group.setModuleAt(1, moduleB);
+ *   group.begin();
+ * }
+ *
+ * void loop() {
+ *   group.renderFieldWhenReady();
+ * }
+ * @endcode
+ *
+ * @tparam T_SIZE number of modules
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()). The default is ClockInterface.
+ * @tparam T_TIMER (optional) class that provides access to a hardware timer
+ *    which drives renderFieldNow() after startTimer(). The default is
+ *    NoTimerInterface, which does nothing.
+ */
+template <
+    uint8_t T_SIZE,
+    typename T_CI = ClockInterface,
+    typename T_TIMER = NoTimerInterface>
+class ScanningGroup {
+    static_assert(T_SIZE > 0, "ScanningGroup requires at least one module");
+
+  public:
+    /**
+     * Set the module at position `i`, which is rendered after the module at
+     * `i - 1`. T_MODULE is any ScanningModule or subclass.
+     */
+    template <typename T_MODULE>
+    void setModuleAt(uint8_t i, T_MODULE& module) {
+      mModules[i].module = &module;
+      mModules[i].renderField = &renderModuleField<T_MODULE>;
+      mModules[i].microsPerField = module.getMicrosPerField();
+    }
+
+    /**
+     * Compute the period of the group from the modules, and restart from the
+     * first one. Call this after the begin() of every module, and after
+     * setModuleAt().
+     */
+    void begin() {
+      uint16_t microsPerField = mModules[0].microsPerField;
+      for (uint8_t i = 1; i < T_SIZE; ++i) {
+        if (mModules[i].microsPerField < microsPerField) {
+          microsPerField = mModules[i].microsPerField;
+        }
+      }
+      mMicrosPerField = microsPerField / T_SIZE;
+      mCurrentModule = 0;
+      mNextFieldMicros = T_CI::micros();
+    }
+
+    /** A no-op end() function for consistency with other classes. */
+    void end() {}
+
+    /**
+     * Return micros per field of the group. This is how often renderFieldNow()
+     * must be called, i.e. the shortest getMicrosPerField() of the modules
+     * divided by T_SIZE.
+     */
+    uint16_t getMicrosPerField() const { return mMicrosPerField; }
+
+    /**
+     * Render the current field of the current module, then move to the next
+     * module. This is intended to be called from a timer interrupt handler.
+     */
+    void renderFieldNow() {
+      const Entry& entry = mModules[mCurrentModule];
+      entry.renderField(entry.module);
+      ace_common::incrementMod(mCurrentModule, T_SIZE);
+    }
+
+    /**
+     * Render one field when the time is right. This is a polling method, so
+     * call it more often than once every getMicrosPerField(). The deadlines
+     * are advanced from the previous deadline, and are restarted from now if
+     * the poll missed more than one field, like
+     * ScanningModule::renderFieldWhenReady().
+     *
+     * @return Returns true if a field was rendered.
+     */
+    bool renderFieldWhenReady() {
+      const uint32_t now = T_CI::micros();
+      if ((int32_t) (now - mNextFieldMicros) < 0) return false;
+
+      renderFieldNow();
+      mNextFieldMicros += mMicrosPerField;
+      if ((int32_t) (now - mNextFieldMicros) >= 0) {
+        mNextFieldMicros = now + mMicrosPerField;
+      }
+      return true;
+    }
+
+    /**
+     * Attach renderFieldNow() to the interrupt of T_TIMER, with a period of
+     * getMicrosPerField(). Call this after begin().
+     */
+    void startTimer() {
+      T_TIMER::attachInterrupt(timerCallback, this, mMicrosPerField);
+    }
+
+    /** Detach renderFieldNow() from the interrupt of T_TIMER. */
+    void stopTimer() {
+      T_TIMER::detachInterrupt();
+    }
+
+  private:
+    friend class ::ScanningGroupTest_renderFieldNow;
+
+    /** Function which renders one field of a module of a known type. */
+    typedef void (*RenderField)(void* module);
+
+    /** A module, and the function which renders it. */
+    struct Entry {
+      void* module;
+      RenderField renderField;
+      uint16_t microsPerField;
+    };
+
+    template <typename T_MODULE>
+    static void renderModuleField(void* module) {
+      static_cast<T_MODULE*>(module)->renderFieldNow();
+    }
+
+    /** The T_TIMER callback. */
+    static void timerCallback(void* context) {
+      static_cast<ScanningGroup*>(context)->renderFieldNow();
+    }
+
+  private:
+    /** Deadline in micros of the next call to renderFieldNow(). */
+    uint32_t mNextFieldMicros;
+
+    Entry mModules[T_SIZE];
+
+    /** Number of micros between 2 successive calls to renderFieldNow(). */
+    uint16_t mMicrosPerField;
+
+    /** Index of the module rendered by the next renderFieldNow(). */
+    uint8_t mCurrentModule;
+};
+
+}
+
+#endif
@@ -29,13 +29,336 @@ SOFTWARE.
 #include <string.h> // memset()
 #include <AceCommon.h> // incrementMod()
 #include "../hw/ClockInterface.h" // ClockInterface
+#include "../hw/TimerInterface.h" // NoTimerInterface
 #include "../LedModule.h"
+#include "../TimingProbe.h"
+#include "ScanningOptions.h"
+#include "ScanningPlan.h"
+#include "ScanningSegmentMajor.h"
 
 class ScanningModuleTest_isAnyDigitDirty;
 class ScanningModuleTest_isBrightnessDirty;
 
 namespace ace_segment {
 
+namespace internal {
+
+/**
+ * Tag type used to select one of 2 overloaded member functions at compile
+ * time, so that the unselected one, which may use members that do not exist
+ * in a given configuration, is never instantiated.
+ */
+template <bool T_VALUE>
+struct BoolConstant {};
+
+/** Determine if T is void, without depending on <type_traits>. */
+template <typename T>
+struct IsVoid { static const bool kValue = false; };
+
+template <>
+struct IsVoid<void> { static const bool kValue = true; };
+
+/**
+ * Select T_TRUE or T_FALSE as `Type`, without depending on <type_traits>,
+ * which is not available on AVR.
+ */
+template <bool T_COND, typename T_TRUE, typename T_FALSE>
+struct Conditional { typedef T_TRUE Type; };
+
+template <typename T_TRUE, typename T_FALSE>
+struct Conditional<false, T_TRUE, T_FALSE> { typedef T_FALSE Type; };
+
+/** Return the largest power of 2 which is less than or equal to `n`. */
+constexpr uint8_t topBit(uint8_t n) {
+  return (n <= 1) ? n : 2 * topBit(n / 2);
+}
+
+/**
+ * Storage for the reference to the LedMatrix of a ScanningModule which is
+ * used directly, instead of through a subclass which owns the LedMatrix.
+ * ScanningModule inherits from this class privately, so that the disabled
+ * specialization is optimized away by the empty base class optimization.
+ *
+ * @tparam T_LM the LedMatrixBase class
+ * @tparam T_ENABLED true if the ScanningModule has no T_DERIVED subclass
+ */
+template <typename T_LM, bool T_ENABLED>
+class ScanningLedMatrixRef {
+  protected:
+    explicit ScanningLedMatrixRef(const T_LM& ledMatrix) :
+        mLedMatrixRef(ledMatrix)
+    {}
+
+    /** LedMatrixBase instance that knows how to set and unset LED segments. */
+    const T_LM& mLedMatrixRef;
+};
+
+/**
+ * Specialization used when the T_DERIVED subclass owns the LedMatrix, so that
+ * ScanningModule can access it at a fixed offset from `this`.
+ */
+template <typename T_LM>
+class ScanningLedMatrixRef<T_LM, false> {};
+
+/**
+ * Storage for the subfield modulation of ScanningModule, which is needed only
+ * if T_SUBFIELDS > 1. ScanningModule inherits from this class privately, so
+ * that the disabled specialization is optimized away by the empty base class
+ * optimization.
+ *
+ * @tparam T_PATTERN type of the segment pattern of one digit
+ * @tparam T_DIGITS number of digits
+ * @tparam T_ENABLED true if T_SUBFIELDS > 1
+ */
+template <typename T_PATTERN, uint8_t T_DIGITS, bool T_ENABLED>
+class ScanningSubFields {
+  protected:
+    /** Restart the modulation at the first subfield. */
+    void resetSubFields() {
+      mCurrentSubField = 0;
+      mPattern = 0;
+    }
+
+    /** Return true if the current subfield is the first of its digit. */
+    bool isFirstSubField() const { return mCurrentSubField == 0; }
+
+    /** Return the subfield which will be rendered next. */
+    uint8_t currentSubField() const { return mCurrentSubField; }
+
+    /** Return the per-digit brightness array. */
+    uint8_t* brightnesses() { return mBrightnesses; }
+
+    /** Return the per-digit brightness array. */
+    const uint8_t* brightnesses() const { return mBrightnesses; }
+
+    /** Brightness for each digit. */
+    uint8_t mBrightnesses[T_DIGITS];
+
+    /**
+     * Used by displayCurrentFieldModulated() and subclasses generated by
+     * fast_driver.py.
+     */
+    uint8_t mCurrentSubField;
+
+    /**
+     * The segment pattern that is currently displaying on the LED. Used to
+     * optimize the displayCurrentFieldModulated() method if the current
+     * pattern is the same as the previous pattern.
+     */
+    T_PATTERN mPattern;
+};
+
+/**
+ * Specialization used when T_SUBFIELDS == 1. Every digit is always at full
+ * brightness, so nothing needs to be stored.
+ */
+template <typename T_PATTERN, uint8_t T_DIGITS>
+class ScanningSubFields<T_PATTERN, T_DIGITS, false> {
+  protected:
+    void resetSubFields() {}
+
+    bool isFirstSubField() const { return true; }
+
+    uint8_t currentSubField() const { return 0; }
+
+    uint8_t* brightnesses() { return nullptr; }
+
+    const uint8_t* brightnesses() const { return nullptr; }
+};
+
+/**
+ * Storage of the per-segment brightness levels of
+ * kScanningOptionSegmentBrightness, as T_SUBFIELDS threshold masks per digit.
+ * Bit `s` of the mask of subfield `n` of a digit is set if segment `s` of that
+ * digit is on in subfield `n`, i.e. if its brightness is greater than `n`.
+ * ScanningModule inherits from this class privately, so that the disabled
+ * specialization is optimized away by the empty base class optimization.
+ *
+ * @tparam T_DIGITS number of digits
+ * @tparam T_SUBFIELDS number of PWM subfields per digit
+ * @tparam T_ENABLED true if kScanningOptionSegmentBrightness is selected
+ */
+template <uint8_t T_DIGITS, uint8_t T_SUBFIELDS, bool T_ENABLED>
+class ScanningSegmentBrightness {
+  protected:
+    /** Set every segment to full brightness. */
+    void resetSegmentBrightness() {
+      memset(mMasks, 0xFF, sizeof(mMasks));
+    }
+
+    /**
+     * Set the brightness of a segment of the digit at `pos`. Each mask is
+     * updated with a single store, because the renderer may be reading it.
+     */
+    void setSegmentLevel(uint8_t pos, uint8_t segment, uint8_t brightness) {
+      const uint8_t bit = 0x1 << segment;
+      uint8_t* masks = mMasks[pos];
+      for (uint8_t i = 0; i < T_SUBFIELDS; i++) {
+        masks[i] = (i < brightness) ? (masks[i] | bit) : (masks[i] & ~bit);
+      }
+    }
+
+    /** Return the brightness of a segment of the digit at `pos`. */
+    uint8_t segmentLevel(uint8_t pos, uint8_t segment) const {
+      const uint8_t bit = 0x1 << segment;
+      uint8_t brightness = 0;
+      while (brightness < T_SUBFIELDS && (mMasks[pos][brightness] & bit)) {
+        brightness++;
+      }
+      return brightness;
+    }
+
+    /** Return the mask of the segments of `pos` which are on in `subField`. */
+    uint8_t segmentMask(uint8_t pos, uint8_t subField) const {
+      return mMasks[pos][subField];
+    }
+
+  private:
+    uint8_t mMasks[T_DIGITS][T_SUBFIELDS];
+};
+
+/**
+ * Specialization used when kScanningOptionSegmentBrightness is not selected.
+ * Every segment is at the brightness of its digit.
+ */
+template <uint8_t T_DIGITS, uint8_t T_SUBFIELDS>
+class ScanningSegmentBrightness<T_DIGITS, T_SUBFIELDS, false> {
+  protected:
+    void resetSegmentBrightness() {}
+
+    void setSegmentLevel(
+        uint8_t /*pos*/, uint8_t /*segment*/, uint8_t /*brightness*/) {}
+
+    uint8_t segmentLevel(uint8_t /*pos*/, uint8_t /*segment*/) const {
+      return T_SUBFIELDS;
+    }
+
+    /** Keep all segments, of both 8-bit and 16-bit patterns. */
+    uint16_t segmentMask(uint8_t /*pos*/, uint8_t /*subField*/) const {
+      return 0xFFFF;
+    }
+};
+
+/**
+ * Storage and logic of the fade engine of kScanningOptionFade. ScanningModule
+ * inherits from this class privately, so that the disabled specialization is
+ * optimized away by the empty base class optimization.
+ *
+ * The target brightness and the fade parameters are written only by the
+ * application, and the current level and the direction of the pulses are
+ * written only by the renderer. Each of them is a single byte per digit, or a
+ * bit in a byte written by only one side, so that neither side needs to
+ * disable interrupts.
+ *
+ * @tparam T_DIGITS number of digits
+ * @tparam T_ENABLED true if kScanningOptionFade is selected
+ */
+template <uint8_t T_DIGITS, bool T_ENABLED>
+class ScanningFade {
+  protected:
+    /** Number of fractional bits of the fade steps and levels. */
+    static const uint8_t kFadeFractionBits = 4;
+
+    /** Jump to the targets immediately, from level 0, without pulses. */
+    void resetFade() {
+      memset(mFadeSteps, 0, sizeof(mFadeSteps));
+      memset(mFadeLevels, 0, sizeof(mFadeLevels));
+      memset(mFadeFractions, 0, sizeof(mFadeFractions));
+      memset(mPulseBits, 0, sizeof(mPulseBits));
+      memset(mFallingBits, 0, sizeof(mFallingBits));
+    }
+
+    /** Set the fade step of the digit at `pos`. Called by the application. */
+    void storeFadeStep(uint8_t pos, uint8_t step) { mFadeSteps[pos] = step; }
+
+    /** Enable or disable the pulse of `pos`. Called by the application. */
+    void storePulse(uint8_t pos, bool pulse) {
+      const uint8_t bit = 0x1 << (pos & 0x07);
+      if (pulse) {
+        mPulseBits[pos >> 3] |= bit;
+      } else {
+        mPulseBits[pos >> 3] &= ~bit;
+      }
+    }
+
+    /**
+     * Move the level of every digit by one step towards its goal, which is its
+     * target, or alternately 0 and the target for a pulsing digit. Called by
+     * the renderer at the start of each frame.
+     */
+    void advanceFade(const uint8_t* targets) {
+      for (uint8_t pos = 0; pos < T_DIGITS; pos++) {
+        const uint8_t bit = 0x1 << (pos & 0x07);
+        const bool pulse = mPulseBits[pos >> 3] & bit;
+        const bool falling = pulse && (mFallingBits[pos >> 3] & bit);
+        const uint16_t goal = falling
+            ? 0 : ((uint16_t) targets[pos] << kFadeFractionBits);
+        const uint8_t step = mFadeSteps[pos];
+        uint16_t level = ((uint16_t) mFadeLevels[pos] << kFadeFractionBits)
+            | mFadeFractions[pos];
+
+        if (step == 0) {
+          level = goal;
+        } else if (level < goal) {
+          level = (goal - level <= step) ? goal : level + step;
+        } else {
+          level = (level - goal <= step) ? goal : level - step;
+        }
+        mFadeLevels[pos] = level >> kFadeFractionBits;
+        mFadeFractions[pos] = level & ((1 << kFadeFractionBits) - 1);
+
+        // Reverse a pulse at each end.
+        if (pulse && level == goal) {
+          mFallingBits[pos >> 3] ^= bit;
+        }
+      }
+    }
+
+    /** Return the brightness to render for the digit at `pos`. */
+    uint8_t fadedBrightness(
+        const uint8_t* /*brightnesses*/, uint8_t pos) const {
+      return mFadeLevels[pos];
+    }
+
+  private:
+    /** Fade step per frame, in 1/16 of a level. Written by the application. */
+    uint8_t mFadeSteps[T_DIGITS];
+
+    /** Integer part of the current level. Written by the renderer. */
+    uint8_t mFadeLevels[T_DIGITS];
+
+    /** Fractional part of the current level. Written by the renderer. */
+    uint8_t mFadeFractions[T_DIGITS];
+
+    /** Digits which pulse. Written by the application. */
+    uint8_t mPulseBits[(T_DIGITS + 7) / 8];
+
+    /** Pulsing digits which are fading out. Written by the renderer. */
+    uint8_t mFallingBits[(T_DIGITS + 7) / 8];
+};
+
+/**
+ * Specialization used when kScanningOptionFade is not selected. The
+ * brightness of each digit is rendered as is.
+ */
+template <uint8_t T_DIGITS>
+class ScanningFade<T_DIGITS, false> {
+  protected:
+    void resetFade() {}
+
+    void storeFadeStep(uint8_t /*pos*/, uint8_t /*step*/) {}
+
+    void storePulse(uint8_t /*pos*/, bool /*pulse*/) {}
+
+    void advanceFade(const uint8_t* /*targets*/) {}
+
+    uint8_t fadedBrightness(const uint8_t* brightnesses, uint8_t pos) const {
+      return brightnesses[pos];
+    }
+};
+
+} // namespace internal
+
 /**
  * An implementation of `LedModule` for display modules which do not have
  * hardware controller chips, so they require the microcontroller to perform the
@@ -56,32 +379,171 @@ namespace ace_segment {
  * Normally, the one digit corresponds to one field. However if brightness
  * control is enabled by setting `T_SUBFIELDS > 1`, then a single digit will be
  * rendered for T_SUBFIELDS number of times so that the brightness of the digit
- * will be controlled by PWM.
+ * will be controlled by PWM. If kScanningOptionBitAngle is selected, the
+ * T_SUBFIELDS subfields of a digit have durations of 1, 2, 4, ... units
+ * instead (bit angle modulation), so that `1 << T_SUBFIELDS` brightness
+ * levels need only T_SUBFIELDS calls to renderFieldNow() per digit. If
+ * kScanningOptionInterleave is selected, each subfield is rendered for every
+ * digit before the next subfield, which spreads the on-time of each digit
+ * across the frame. If kScanningOptionSegmentMajor is selected, a field is
+ * one segment across all digits instead, so that a frame always has 8 fields.
  *
- * There are 2 ways to get the expected number of frames per second:
+ * There are 3 ways to get the expected number of frames per second:
  *
- *  1) Call the renderFieldNow() in an ISR, or
+ *  1) Call the renderFieldNow() in an ISR,
  *  2) Call renderFieldWhenReady() polling method repeatedly from the global
  *    loop(), and an internal timing parameter will trigger a renderFieldNow()
- *    at the appropriate time.
+ *    at the appropriate time, or
+ *  3) Select a hardware timer with T_TIMER and call startTimer(). The timer
+ *    interrupt calls renderFieldNow() and re-arms the timer with
+ *    getMicrosUntilNextField(), so that the variable field durations of
+ *    kScanningOptionBitAngle and kScanningOptionSkipBlank are supported.
  *
  * @tparam T_LM the LedMatrixBase class that provides access to LED segments
       (elements) organized by digit (group)
  * @tparam T_DIGITS number of LED digits
  * @tparam T_SUBFIELDS number of subfields for each digit to get brightness
  *    control using PWM. The default is 1, but can be set to greater than 1 to
- *    get brightness control.
+ *    get brightness control. With kScanningOptionBitAngle, this is the number
+ *    of bits of brightness, from 1 to 8.
  * @tparam T_CI class that provides access to Arduino clock functions (millis()
  *    and micros()). The default is ClockInterface.
+ * @tparam T_OPTIONS bit mask of optional features, composed of the
+ *    `kScanningOptionXxx` flags defined in ScanningOptions.h. The default is 0,
+ *    which disables all of them at no cost in RAM or CPU.
+ * @tparam T_DERIVED (optional) the subclass which owns the instance of T_LM
+ *    in a member named `mLedMatrix`, accessible to ScanningModule, following
+ *    the Curiously Recurring Template Pattern. ScanningModule then accesses
+ *    the LedMatrix directly, instead of through a reference, which saves a
+ *    pointer and an indirect load in renderFieldNow(). The default is `void`,
+ *    which means that the LedMatrix is passed into the constructor by
+ *    reference.
+ * @tparam T_PROBE (optional) the instrumentation policy which times
+ *    renderFieldNow(), e.g. TimingProbe<>. The default is NoTimingProbe, which
+ *    compiles away.
+ * @tparam T_TIMER (optional) class that provides access to a hardware timer
+ *    which drives renderFieldNow() after startTimer(), e.g.
+ *    TimerOneInterface. The default is NoTimerInterface, which does nothing.
+ * @tparam T_PATTERN (optional) type of the segment pattern of one digit. The
+ *    default is `uint8_t` for seven-segment digits. Use `uint16_t` for
+ *    14-segment or 16-segment digits, with a T_LM whose draw() accepts 16-bit
+ *    element patterns, i.e. LedMatrixDirect or LedMatrixSingleHc595 with
+ *    their `T_PATTERN` set to `uint16_t`. The
+ *    kScanningOptionSegmentMajor and kScanningOptionSegmentBrightness
+ *    options require `uint8_t`. A `uint16_t` pattern is not written
+ *    atomically on 8-bit processors, so renderFieldNow() called from an ISR
+ *    (including startTimer() and ScanningGroup) requires
+ *    kScanningOptionDoubleBuffer, otherwise a digit can show half of its old
+ *    pattern and half of its new one. startTimer() checks this at compile
+ *    time.
  */
 template <
     typename T_LM,
     uint8_t T_DIGITS,
     uint8_t T_SUBFIELDS = 1,
-    typename T_CI = ClockInterface>
-class ScanningModule : public LedModule {
+    typename T_CI = ClockInterface,
+    uint16_t T_OPTIONS = 0,
+    typename T_DERIVED = void,
+    typename T_PROBE = NoTimingProbe,
+    typename T_TIMER = NoTimerInterface,
+    typename T_PATTERN = uint8_t>
+class ScanningModule :
+    public BasicLedModule<T_PATTERN, LedModule::numDirtyBytes(T_DIGITS)>,
+    private T_PROBE,
+    private internal::ScanningLedMatrixRef<
+        T_LM, internal::IsVoid<T_DERIVED>::kValue>,
+    private internal::ScanningSubFields<
+        T_PATTERN, T_DIGITS, (T_SUBFIELDS > 1)>,
+    private internal::ScanningSegmentBrightness<
+        T_DIGITS,
+        T_SUBFIELDS,
+        (T_OPTIONS & kScanningOptionSegmentBrightness) != 0>,
+    private internal::ScanningLateStats<
+        (T_OPTIONS & kScanningOptionLateStats) != 0>,
+    private internal::ScanningFade<
+        T_DIGITS, (T_OPTIONS & kScanningOptionFade) != 0>,
+    private internal::ScanningDither<
+        (T_OPTIONS & kScanningOptionDither) != 0>,
+    private internal::ScanningSkipBlank<
+        (T_OPTIONS & kScanningOptionSkipBlank) != 0>,
+    private internal::ScanningSegmentMajor<
+        T_DIGITS, (T_OPTIONS & kScanningOptionSegmentMajor) != 0>,
+    private internal::Conditional<
+        (T_OPTIONS & kScanningOptionScanPlan) != 0,
+        internal::ScanningPlan<T_PATTERN, T_DIGITS, T_SUBFIELDS>,
+        internal::ScanningFrontBuffer<
+            T_PATTERN,
+            T_DIGITS,
+            T_SUBFIELDS,
+            (T_OPTIONS & kScanningOptionDoubleBuffer) != 0>
+    >::Type {
+
+    static_assert(!(T_OPTIONS & kScanningOptionBitAngle) || T_SUBFIELDS <= 8,
+        "kScanningOptionBitAngle supports at most 8 subfields");
+    static_assert(!(T_OPTIONS & kScanningOptionScanPlan)
+        || (T_OPTIONS & kScanningOptionDoubleBuffer),
+        "kScanningOptionScanPlan requires kScanningOptionDoubleBuffer");
+    static_assert(!(T_OPTIONS & kScanningOptionScanPlan)
+        || !(T_OPTIONS & kScanningOptionBitAngle),
+        "kScanningOptionScanPlan does not support kScanningOptionBitAngle");
+    static_assert(!(T_OPTIONS & kScanningOptionScanPlan)
+        || !(T_OPTIONS & kScanningOptionSkipBlank),
+        "kScanningOptionScanPlan does not support kScanningOptionSkipBlank");
+    static_assert(!(T_OPTIONS & kScanningOptionSegmentMajor)
+        || (T_SUBFIELDS == 1 && T_DIGITS <= 16),
+        "kScanningOptionSegmentMajor requires T_SUBFIELDS == 1 and "
+        "T_DIGITS <= 16");
+    static_assert(!(T_OPTIONS & kScanningOptionSegmentMajor)
+        || !(T_OPTIONS & (kScanningOptionBitAngle | kScanningOptionScanPlan
+            | kScanningOptionSkipBlank)),
+        "kScanningOptionSegmentMajor does not support the other rendering "
+        "options");
+    static_assert(!(T_OPTIONS & kScanningOptionSegmentBrightness)
+        || (T_SUBFIELDS > 1
+            && !(T_OPTIONS & (kScanningOptionBitAngle
+                | kScanningOptionScanPlan))),
+        "kScanningOptionSegmentBrightness requires T_SUBFIELDS > 1, and does "
+        "not support kScanningOptionBitAngle or kScanningOptionScanPlan");
+    static_assert(!(T_OPTIONS & kScanningOptionDither)
+        || (T_SUBFIELDS > 1
+            && !(T_OPTIONS & kScanningOptionScanPlan)
+            && (!(T_OPTIONS & kScanningOptionBitAngle) || T_SUBFIELDS <= 5)
+            && T_SUBFIELDS <= 31),
+        "kScanningOptionDither requires T_SUBFIELDS > 1 and a maximum "
+        "undithered brightness <= 31, and does not support "
+        "kScanningOptionScanPlan");
+    static_assert(!(T_OPTIONS & kScanningOptionFade)
+        || (T_SUBFIELDS > 1 && !(T_OPTIONS & kScanningOptionScanPlan)),
+        "kScanningOptionFade requires T_SUBFIELDS > 1, and does not support "
+        "kScanningOptionScanPlan");
+    static_assert(!(T_OPTIONS & kScanningOptionInterleave)
+        || (T_SUBFIELDS > 1
+            && !(T_OPTIONS & (kScanningOptionScanPlan
+                | kScanningOptionSkipBlank))),
+        "kScanningOptionInterleave requires T_SUBFIELDS > 1, and does not "
+        "support kScanningOptionScanPlan or kScanningOptionSkipBlank");
+    static_assert(sizeof(T_PATTERN) == 1
+        || !(T_OPTIONS & (kScanningOptionSegmentMajor
+            | kScanningOptionSegmentBrightness)),
+        "kScanningOptionSegmentMajor and kScanningOptionSegmentBrightness "
+        "require 8-bit patterns");
+
+    using Super =
+        BasicLedModule<T_PATTERN, LedModule::numDirtyBytes(T_DIGITS)>;
 
   public:
+    /**
+     * The brightness which turns on a digit 100% of the time, i.e. T_SUBFIELDS,
+     * or `(1 << T_SUBFIELDS) - 1` with kScanningOptionBitAngle, multiplied by
+     * `1 << kScanningDitherBits` with kScanningOptionDither. Can be used as
+     * the T_MAX_BRIGHTNESS of PerceivedBrightness.
+     */
+    static const uint8_t kMaxBrightness = (uint8_t) (
+        ((T_OPTIONS & kScanningOptionBitAngle)
+            ? ((1 << T_SUBFIELDS) - 1)
+            : T_SUBFIELDS)
+        << ((T_OPTIONS & kScanningOptionDither) ? kScanningDitherBits : 0));
+
     /**
      * Constructor.
      *
@@ -96,8 +558,19 @@ class ScanningModule : public LedModule {
         const T_LM& ledMatrix,
         uint8_t framesPerSecond
     ):
-        LedModule(mPatterns, T_DIGITS),
-        mLedMatrix(ledMatrix),
+        Super(mPatterns, T_DIGITS),
+        internal::ScanningLedMatrixRef<T_LM, true>(ledMatrix),
+        mFramesPerSecond(framesPerSecond)
+    {}
+
+    /**
+     * Constructor used by a T_DERIVED subclass which owns the LedMatrix.
+     *
+     * @param framesPerSecond the rate at which all digits of the LED display
+     *    will be refreshed
+     */
+    explicit ScanningModule(uint8_t framesPerSecond):
+        Super(mPatterns, T_DIGITS),
         mFramesPerSecond(framesPerSecond)
     {}
 
@@ -108,38 +581,85 @@ class ScanningModule : public LedModule {
      * time.
      */
     void begin() {
-      LedModule::begin();
-      memset(mPatterns, 0, T_DIGITS);
+      Super::begin();
+      memset(mPatterns, 0, sizeof(mPatterns));
+      this->resetFront();
+      this->resetSegmentMajor();
 
-      // Set up durations for the renderFieldWhenReady() polling function.
-      mMicrosPerField = (uint32_t) 1000000UL / getFieldsPerSecond();
-      mLastRenderFieldMicros = T_CI::micros();
+      // Set up durations for the renderFieldWhenReady() polling function. A
+      // group is on for at most kFieldUnits units of mMicrosPerField.
+      mMicrosPerField = (uint32_t) 1000000UL
+          / ((uint32_t) mFramesPerSecond * kNumGroups * kFieldUnits);
+      mNextFieldMicros = T_CI::micros();
+      this->resetLateStats();
+      this->setLitDigits(T_DIGITS, mMicrosPerField);
+      getTimingProbe().resetTiming();
+      getTimingProbe().setBudgetMicros(mMicrosPerField);
 
       // Initialize variables needed for multiplexing.
       mCurrentDigit = 0;
-      mPrevDigit = T_DIGITS - 1;
-      mCurrentSubField = 0;
-      mPattern = 0;
+      mPrevDigit = kNumGroups - 1;
+      this->resetSubFields();
+      this->resetDither();
+      this->resetFade();
+      this->resetSegmentBrightness();
 
       // Set initial patterns and global brightness.
-      mIsDigitBrightnessDirty = false;
-      mLedMatrix.clear();
+      ledMatrix().clear();
       if (T_SUBFIELDS > 1) {
-        setBrightness(T_SUBFIELDS / 2); // half brightness
+        setBrightness(kMaxBrightness / 2); // half brightness
       }
+
+      // The global brightness is copied into the per-digit brightness by
+      // setBrightness(), so the global dirty flag is never needed.
+      this->clearBrightnessDirty();
+
+      // Seed the front buffer of kScanningOptionDoubleBuffer with the blank
+      // patterns and the initial brightness, so that the fields rendered
+      // before the first commit() are not rendered at brightness 0. The
+      // renderer is not running yet, so the commit is applied right away.
+      this->requestFrontCommit(mPatterns, this->brightnesses());
+      this->applyFrontCommit();
     }
 
 
     /** A no-op end() function for consistency with other classes. */
     void end() {
-      LedModule::end();
+      Super::end();
     }
 
     //-----------------------------------------------------------------------
     // Additional brightness control. ScanningModule allows brightness to be
     // defined on a per-digit basis.
+    //
+    // The brightness levels are written only by the calling context (e.g.
+    // loop()), and only read by renderFieldNow() (e.g. from an ISR). Each
+    // level is a single byte, so renderFieldNow() sees either the old or the
+    // new value of a digit, never a mix, without disabling interrupts. Use
+    // kScanningOptionDoubleBuffer to make the brightness of all digits change
+    // in the same frame.
+    //
+    // This does not hold for 16-bit patterns, which setPatternAt() writes with
+    // 2 stores on 8-bit processors, so an ISR can render half of the new
+    // pattern. They need kScanningOptionDoubleBuffer when renderFieldNow() is
+    // called from an ISR.
     //-----------------------------------------------------------------------
 
+    /**
+     * Set the brightness of all digits. This hides LedModule::setBrightness().
+     * The global brightness is copied into the per-digit brightness
+     * immediately, instead of by renderFieldNow(), so that a following
+     * setBrightnessAt() is not overwritten, and the renderer never writes
+     * the brightness levels.
+     */
+    void setBrightness(uint8_t brightness) {
+      Super::setBrightness(brightness);
+      for (uint8_t i = 0; i < T_DIGITS; i++) {
+        setBrightnessAt(i, brightness);
+      }
+      this->clearBrightnessDirty();
+    }
+
     /**
      * Set the brightness for a given pos, leaving pattern unchanged.
      * Not all implementation of `LedClass` can support brightness for each
@@ -149,7 +669,12 @@ class ScanningModule : public LedModule {
      * LED 100% of the time. The minimum brightness is 0, which turns OFF the
      * digit. For example, if `T_SUBFIELDS==16`, the the maximum brightness is
      * 16 which turns ON the digit 100% of the time. The relative brightness of
-     * each brightness level is in units of 1/T_SUBFIELDS.
+     * each brightness level is in units of 1/T_SUBFIELDS. With
+     * kScanningOptionBitAngle, the maximum brightness is
+     * `(1 << T_SUBFIELDS) - 1` instead, in units of 1/((1 << T_SUBFIELDS) - 1).
+     * With kScanningOptionDither, the brightness has kScanningDitherBits more
+     * bits, up to kMaxBrightness, and the fraction is rendered by alternating
+     * between the 2 nearest levels across frames.
      *
      * The brightness scale is *not* normalized to [0,255]. A previous version
      * of this class tried to do that, but I found that this introduced
@@ -164,10 +689,126 @@ class ScanningModule : public LedModule {
      * to implement.
      */
     void setBrightnessAt(uint8_t pos, uint8_t brightness) {
+      if (T_SUBFIELDS <= 1) return;
+      if (pos >= T_DIGITS) return;
+      this->brightnesses()[pos] = (brightness >= kMaxBrightness)
+          ? kMaxBrightness : brightness;
+    }
+
+    /**
+     * Get the brightness of the given pos. Always the maximum brightness (i.e.
+     * 1) if T_SUBFIELDS <= 1, because every digit is then fully on.
+     */
+    uint8_t getBrightnessAt(uint8_t pos) const {
+      if (T_SUBFIELDS <= 1) return kMaxBrightness;
+      return this->brightnesses()[pos];
+    }
+
+    /**
+     * Set the fade step of the digit at `pos`, in units of 1/16 of a
+     * brightness level per frame, for kScanningOptionFade. The digit then
+     * fades from its current brightness to the brightness set by
+     * setBrightnessAt(). A step of 0, the default, changes the brightness at
+     * the next frame.
+     */
+    void setFadeStepAt(uint8_t pos, uint8_t step) {
+      static_assert(T_OPTIONS & kScanningOptionFade,
+          "setFadeStepAt() requires kScanningOptionFade");
       if (pos >= T_DIGITS) return;
-      mBrightnesses[pos] = (brightness >= T_SUBFIELDS)
-          ? T_SUBFIELDS : brightness;
-      mIsDigitBrightnessDirty = true;
+      this->storeFadeStep(pos, step);
+    }
+
+    /** Set the fade step of all digits. */
+    void setFadeStep(uint8_t step) {
+      for (uint8_t i = 0; i < T_DIGITS; i++) {
+        setFadeStepAt(i, step);
+      }
+    }
+
+    /**
+     * Make the digit at `pos` pulse continuously between 0 and the brightness
+     * set by setBrightnessAt(), using its fade step, for kScanningOptionFade.
+     */
+    void setPulseAt(uint8_t pos, bool pulse) {
+      static_assert(T_OPTIONS & kScanningOptionFade,
+          "setPulseAt() requires kScanningOptionFade");
+      if (pos >= T_DIGITS) return;
+      this->storePulse(pos, pulse);
+    }
+
+    /**
+     * Return the brightness of the digit at `pos` which is being rendered in
+     * the current frame. This is getBrightnessAt(), except during a fade or a
+     * pulse of kScanningOptionFade.
+     */
+    uint8_t getRenderedBrightnessAt(uint8_t pos) const {
+      if (T_SUBFIELDS <= 1) return kMaxBrightness;
+      return this->fadedBrightness(
+          this->frontBrightnesses(this->brightnesses()), pos);
+    }
+
+    /**
+     * Set the brightness of one segment (bit 0 to 7 of the pattern) of the
+     * digit at `pos`, from 0 to T_SUBFIELDS. The segment shows the lower of
+     * its own brightness and the brightness of its digit. Requires
+     * kScanningOptionSegmentBrightness. All segments are at T_SUBFIELDS after
+     * begin().
+     */
+    void setSegmentBrightnessAt(
+        uint8_t pos, uint8_t segment, uint8_t brightness) {
+      static_assert(T_OPTIONS & kScanningOptionSegmentBrightness,
+          "setSegmentBrightnessAt() requires "
+          "kScanningOptionSegmentBrightness");
+      if (pos >= T_DIGITS || segment >= 8) return;
+      this->setSegmentLevel(pos, segment, brightness);
+    }
+
+    /** Set the brightness of one segment of all digits. */
+    void setSegmentBrightness(uint8_t segment, uint8_t brightness) {
+      for (uint8_t i = 0; i < T_DIGITS; i++) {
+        setSegmentBrightnessAt(i, segment, brightness);
+      }
+    }
+
+    /**
+     * Get the brightness of one segment of the digit at `pos`. Always
+     * T_SUBFIELDS if kScanningOptionSegmentBrightness is not selected.
+     */
+    uint8_t getSegmentBrightnessAt(uint8_t pos, uint8_t segment) const {
+      return this->segmentLevel(pos, segment);
+    }
+
+    //-----------------------------------------------------------------------
+    // Double buffering, enabled by kScanningOptionDoubleBuffer.
+    //-----------------------------------------------------------------------
+
+    /**
+     * Publish the patterns and brightness levels written since the previous
+     * commit(). They are copied into a second front buffer here, in the
+     * calling context, and become visible as a whole at the start of the next
+     * frame, when the renderer switches to that front buffer. With
+     * kScanningOptionScanPlan, the scan plan of the next frame is built here
+     * instead.
+     *
+     * The renderer never reads the patterns or brightness levels written by
+     * the application, so they can be modified at any time. But commit()
+     * returns false, and publishes nothing, while isCommitPending() is true,
+     * so that the buffer being picked up by the renderer is never
+     * overwritten. A typical loop() checks isCommitPending() first, and skips
+     * the update if the previous frame has not been picked up yet.
+     */
+    bool commit() {
+      static_assert(T_OPTIONS & kScanningOptionDoubleBuffer,
+          "commit() requires kScanningOptionDoubleBuffer");
+      return this->requestFrontCommit(mPatterns, this->brightnesses());
+    }
+
+    /**
+     * Return true if the last commit() has not been picked up by the renderer.
+     * Always false if kScanningOptionDoubleBuffer is not selected.
+     */
+    bool isCommitPending() const {
+      return this->isFrontCommitPending();
     }
 
     //-----------------------------------------------------------------------
@@ -182,73 +823,291 @@ class ScanningModule : public LedModule {
       return mFramesPerSecond * getFieldsPerFrame();
     }
 
-    /** Total fields per frame across all digits. */
-    uint16_t getFieldsPerFrame() const { return T_DIGITS * T_SUBFIELDS; }
+    /**
+     * Total fields per frame across all digits. Always 8 with
+     * kScanningOptionSegmentMajor.
+     */
+    uint16_t getFieldsPerFrame() const { return kNumGroups * T_SUBFIELDS; }
 
     /**
      * Return micros per field. This is how often renderFieldNow() must be
-     * called from a timer interrupt.
+     * called from a timer interrupt. With kScanningOptionBitAngle, this is the
+     * duration of the shortest subfield, see getMicrosUntilNextField().
      */
     uint16_t getMicrosPerField() const { return mMicrosPerField; }
 
+    /**
+     * Return the duration of a frame in micros, as scheduled by
+     * renderFieldWhenReady() in whole multiples of getMicrosPerField().
+     */
+    uint32_t getMicrosPerFrame() const {
+      return (uint32_t) mMicrosPerField * kNumGroups * kFieldUnits;
+    }
+
+    /**
+     * Return the number of micros that the field rendered by the previous
+     * renderFieldNow() should stay on, before the next call. This is always
+     * getMicrosPerField(), except with kScanningOptionBitAngle, where the
+     * subfield of bit `n` stays on for `getMicrosPerField() << n`, and with
+     * kScanningOptionSkipBlank, where the fields are stretched by the ratio
+     * of T_DIGITS to the number of lit digits, or last a whole frame if all
+     * digits are blank. An interrupt handler should reprogram its timer with
+     * this value after each renderFieldNow().
+     */
+    uint16_t getMicrosUntilNextField() const {
+      const uint16_t micros = kSkipBlank
+          ? this->microsPerLitField() : mMicrosPerField;
+      if (! kBitAngle) return micros;
+      if (kSkipBlank && this->numLitDigits() == 0) return micros;
+      // With kScanningOptionInterleave, the subfield advances only after the
+      // last digit.
+      const uint8_t subField = this->currentSubField();
+      const uint8_t prevSubField = (kInterleave && mCurrentDigit != 0)
+          ? subField
+          : (subField == 0) ? T_SUBFIELDS - 1 : subField - 1;
+      return micros << prevSubField;
+    }
+
     /**
      * Display one field of a frame when the time is right. This is a polling
      * method, so call this slightly more frequently than getFieldsPerSecond()
      * per second.
      *
+     * The deadline of the next field is advanced from the deadline of the
+     * current field, not from the time of the poll, so that late polls do
+     * not lower the frame rate below getFramesPerSecond(). If a poll is so late
+     * that the following deadline has passed too, the missed fields are
+     * skipped, or rendered back-to-back with kScanningOptionCatchUpBurst.
+     *
+     * With kScanningOptionLateStats, getNumLateFields() and getMaxLateMicros()
+     * show how close the polling loop is to visible flicker.
+     *
      * @return Returns true if renderFieldNow() was called and the field was
      *    rendered.
      */
     bool renderFieldWhenReady() {
-      uint16_t now = T_CI::micros();
-      uint16_t elapsedMicros = now - mLastRenderFieldMicros;
-      if (elapsedMicros >= mMicrosPerField) {
-        renderFieldNow();
-        mLastRenderFieldMicros = now;
-        return true;
-      } else {
-        return false;
+      const uint32_t now = T_CI::micros();
+      const uint32_t lateMicros = now - mNextFieldMicros;
+      if ((int32_t) lateMicros < 0) return false;
+
+      renderFieldNow();
+      this->recordLateness(lateMicros, mMicrosPerField);
+
+      mNextFieldMicros += getMicrosUntilNextField();
+      const uint32_t backlogMicros = now - mNextFieldMicros;
+      if ((int32_t) backlogMicros >= 0) {
+        // The following deadline has passed too.
+        if (! (T_OPTIONS & kScanningOptionCatchUpBurst)
+            || backlogMicros >= getMicrosPerFrame()) {
+          mNextFieldMicros = now + getMicrosUntilNextField();
+        }
       }
+      return true;
     }
 
+    /**
+     * Return the number of fields which renderFieldWhenReady() rendered at
+     * least getMicrosPerField() after their deadline, since begin() or
+     * clearLateStats(). Always 0 unless kScanningOptionLateStats is selected.
+     */
+    uint16_t getNumLateFields() const { return this->numLateFields(); }
+
+    /**
+     * Return the worst lateness of renderFieldWhenReady() in micros, since
+     * begin() or clearLateStats(). Always 0 unless kScanningOptionLateStats is
+     * selected.
+     */
+    uint16_t getMaxLateMicros() const { return this->maxLateMicros(); }
+
+    /** Clear the statistics of getNumLateFields() and getMaxLateMicros(). */
+    void clearLateStats() { this->resetLateStats(); }
+
     /**
      * Render the current field immediately. If modulation is off (i.e.
      * T_SUBFIELDS == 1), then the field corresponds to the single digit. If
      * modulation is enabled (T_SUBFIELDS > 1), then each digit is PWM modulated
-     * over T_SUBFIELDS number of renderings.
+     * over T_SUBFIELDS number of renderings. With kScanningOptionSkipBlank,
+     * the blank digits get no fields.
      *
      * This method is intended to be called directly from a timer interrupt
      * handler.
      */
     void renderFieldNow() {
-      updateBrightness();
-      if (T_SUBFIELDS > 1) {
-        displayCurrentFieldModulated();
-      } else {
-        displayCurrentFieldPlain();
-      }
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+      renderField(internal::BoolConstant<kScanPlan>());
+    }
+
+    /**
+     * Return the T_PROBE which times renderFieldNow(). Its budget is set to
+     * getMicrosPerField() by begin().
+     */
+    T_PROBE& getTimingProbe() { return *this; }
+
+    /** Return the T_PROBE which times renderFieldNow(). */
+    const T_PROBE& getTimingProbe() const { return *this; }
+
+    /**
+     * Attach renderFieldNow() to the interrupt of T_TIMER, starting with a
+     * period of getMicrosPerField(). Call this after begin(). Does nothing
+     * with the default NoTimerInterface.
+     */
+    void startTimer() {
+      static_assert(sizeof(T_PATTERN) == 1
+          || (T_OPTIONS & kScanningOptionDoubleBuffer),
+          "startTimer() with 16-bit patterns requires "
+          "kScanningOptionDoubleBuffer");
+      T_TIMER::attachInterrupt(timerCallback, this, mMicrosPerField);
+    }
+
+    /** Detach renderFieldNow() from the interrupt of T_TIMER. */
+    void stopTimer() {
+      T_TIMER::detachInterrupt();
     }
 
   private:
     friend class ::ScanningModuleTest_isAnyDigitDirty;
     friend class ::ScanningModuleTest_isBrightnessDirty;
 
+    /** True if kScanningOptionBitAngle is selected. */
+    static const bool kBitAngle = (T_OPTIONS & kScanningOptionBitAngle) != 0;
+
+    /** True if kScanningOptionScanPlan is selected. */
+    static const bool kScanPlan = (T_OPTIONS & kScanningOptionScanPlan) != 0;
+
+    /**
+     * Number of units of getMicrosPerField() for which a digit is on at its
+     * maximum brightness.
+     */
+    static const uint8_t kFieldUnits = kBitAngle
+        ? (uint8_t) ((1 << T_SUBFIELDS) - 1)
+        : T_SUBFIELDS;
+
+    /** True if kScanningOptionDither is selected. */
+    static const bool kDither = (T_OPTIONS & kScanningOptionDither) != 0;
+
+    /** True if kScanningOptionSkipBlank is selected. */
+    static const bool kSkipBlank = (T_OPTIONS & kScanningOptionSkipBlank) != 0;
+
+    /** True if kScanningOptionInterleave is selected. */
+    static const bool kInterleave =
+        (T_OPTIONS & kScanningOptionInterleave) != 0;
+
+    /** Top bit of the largest subfield, for nextInterleavedSubField(). */
+    static const uint8_t kSubFieldTopBit =
+        internal::topBit(T_SUBFIELDS - 1);
+
+    /** True if kScanningOptionSegmentMajor is selected. */
+    static const bool kSegmentMajor =
+        (T_OPTIONS & kScanningOptionSegmentMajor) != 0;
+
+    /** Number of groups (digits, or segments) scanned in each frame. */
+    static const uint8_t kNumGroups = kSegmentMajor
+        ? internal::ScanningSegmentMajor<T_DIGITS, true>::kNumSegments
+        : T_DIGITS;
+
     // disable copy-constructor and assignment operator
     ScanningModule(const ScanningModule&) = delete;
     ScanningModule& operator=(const ScanningModule&) = delete;
 
+    /**
+     * Return the LedMatrix, either through the reference passed into the
+     * constructor, or directly from the T_DERIVED subclass.
+     */
+    const T_LM& ledMatrix() const {
+      return ledMatrix(
+          internal::BoolConstant<internal::IsVoid<T_DERIVED>::kValue>());
+    }
+
+    const T_LM& ledMatrix(internal::BoolConstant<true>) const {
+      return this->mLedMatrixRef;
+    }
+
+    const T_LM& ledMatrix(internal::BoolConstant<false>) const {
+      return static_cast<const T_DERIVED*>(this)->mLedMatrix;
+    }
+
+    /** Render the next field from the patterns and brightness levels. */
+    void renderField(internal::BoolConstant<false>) {
+      if ((T_OPTIONS & kScanningOptionDoubleBuffer)
+          && mCurrentDigit == 0
+          && this->isFirstSubField()) {
+        this->applyFrontCommit();
+      }
+      displayCurrentField(internal::BoolConstant<(T_SUBFIELDS > 1)>());
+    }
+
+    /**
+     * Render the next field from the internal::ScanningPlan. The plan built
+     * by commit() is picked up at the start of a frame.
+     */
+    void renderField(internal::BoolConstant<true>) {
+      if (this->isPlanAtFrameStart()) {
+        this->applyFrontCommit();
+      }
+      const internal::ScanPlanEntry<T_PATTERN>* entry = this->stepPlan();
+      if (entry) {
+        ledMatrix().draw(entry->group, entry->pattern);
+      }
+    }
+
+    /**
+     * Select displayCurrentFieldPlain() or displayCurrentFieldModulated() at
+     * compile time, so that the modulated version, which uses the members of
+     * internal::ScanningSubFields, is not instantiated if T_SUBFIELDS == 1.
+     */
+    void displayCurrentField(internal::BoolConstant<false>) {
+      displayCurrentFieldPlain();
+    }
+
+    void displayCurrentField(internal::BoolConstant<true>) {
+      displayCurrentFieldModulated();
+    }
+
     /** Display field normally without modulation. */
     void displayCurrentFieldPlain() {
-      const uint8_t pattern = mPatterns[mCurrentDigit];
-      mLedMatrix.draw(mCurrentDigit, pattern);
+      const T_PATTERN* patterns = this->frontPatterns(mPatterns);
+      if (kSegmentMajor) {
+        displayCurrentSegment(patterns);
+        return;
+      }
+      if (kSkipBlank && mCurrentDigit == 0
+          && ! startLitFrame(patterns, nullptr)) {
+        return;
+      }
+
+      ledMatrix().draw(mCurrentDigit, patterns[mCurrentDigit]);
       mPrevDigit = mCurrentDigit;
-      ace_common::incrementMod(mCurrentDigit, T_DIGITS);
+      advanceDigit(patterns, nullptr);
+    }
+
+    /**
+     * Display one segment across all digits, for kScanningOptionSegmentMajor.
+     * mCurrentDigit is the current segment.
+     */
+    void displayCurrentSegment(const T_PATTERN* patterns) {
+      if (mCurrentDigit == 0) this->updateSegmentMajor(patterns);
+      ledMatrix().draw(mCurrentDigit, this->segmentPattern(mCurrentDigit));
+      mPrevDigit = mCurrentDigit;
+      ace_common::incrementMod(mCurrentDigit, kNumGroups);
     }
 
-    /** Display field using subfield modulation. */
+    /** Display field using subfield modulation, either PWM or BAM. */
     void displayCurrentFieldModulated() {
-      // Calculate the maximum subfield duration for current digit.
-      const uint8_t brightness = mBrightnesses[mCurrentDigit];
+      const T_PATTERN* patterns = this->frontPatterns(mPatterns);
+      const uint8_t* brightnesses =
+          this->frontBrightnesses(this->mBrightnesses);
+      if (mCurrentDigit == 0 && this->isFirstSubField()) {
+        this->advanceDither();
+        this->advanceFade(brightnesses);
+      }
+      if (kSkipBlank && mCurrentDigit == 0 && this->isFirstSubField()
+          && ! startLitFrame(patterns, brightnesses)) {
+        return;
+      }
+
+      // Calculate the maximum subfield duration for current digit, in the
+      // current frame if kScanningOptionDither is selected.
+      const uint8_t brightness = frameLevel(brightnesses, mCurrentDigit);
 
       // Implement pulse width modulation PWM, using the following boundaries:
       //
@@ -260,50 +1119,151 @@ class ScanningModule : public LedModule {
       // T_SUBFIELDS, with the value of T_SUBFIELDS being 100% bright. So if we
       // turn on the LED when (mCurrentSubField < brightness), we get the
       // desired outcome.
-      const uint8_t pattern = (mCurrentSubField < brightness)
-          ? mPatterns[mCurrentDigit]
+      //
+      // With bit angle modulation, subfield n lasts for (1 << n) units, so
+      // turning on the LED when bit n of the brightness is set keeps it on
+      // for exactly `brightness` units out of kFieldUnits.
+      const bool isOn = kBitAngle
+          ? ((brightness >> this->mCurrentSubField) & 0x1)
+          : (this->mCurrentSubField < brightness);
+      const T_PATTERN pattern = isOn
+          ? patterns[mCurrentDigit]
+              & this->segmentMask(mCurrentDigit, this->mCurrentSubField)
           : 0;
 
-      if (pattern != mPattern || mCurrentDigit != mPrevDigit) {
-        mLedMatrix.draw(mCurrentDigit, pattern);
-        mPattern = pattern;
+      if (pattern != this->mPattern || mCurrentDigit != mPrevDigit) {
+        ledMatrix().draw(mCurrentDigit, pattern);
+        this->mPattern = pattern;
       }
 
-      mCurrentSubField++;
       mPrevDigit = mCurrentDigit;
-      if (mCurrentSubField >= T_SUBFIELDS) {
+      if (kInterleave) {
+        ace_common::incrementMod(mCurrentDigit, T_DIGITS);
+        if (mCurrentDigit == 0) {
+          this->mCurrentSubField =
+              nextInterleavedSubField(this->mCurrentSubField);
+        }
+        return;
+      }
+
+      this->mCurrentSubField++;
+      if (this->mCurrentSubField >= T_SUBFIELDS) {
+        advanceDigit(patterns, brightnesses);
+        this->mCurrentSubField = 0;
+      }
+    }
+
+    /**
+     * Return the subfield after `subField` in the order of
+     * kScanningOptionInterleave. With linear PWM, the subfields are counted
+     * in bit-reversed order, by propagating the carry from the top bit down,
+     * skipping the values which are not less than T_SUBFIELDS. The sequence
+     * always returns to 0 at the end of the frame.
+     */
+    static uint8_t nextInterleavedSubField(uint8_t subField) {
+      if (kBitAngle) {
+        return (subField + 1 >= T_SUBFIELDS) ? 0 : subField + 1;
+      }
+      do {
+        uint8_t bit = kSubFieldTopBit;
+        while (subField & bit) {
+          subField ^= bit;
+          bit >>= 1;
+        }
+        subField |= bit;
+      } while (subField >= T_SUBFIELDS);
+      return subField;
+    }
+
+    /**
+     * Move mCurrentDigit to the next digit. With kScanningOptionSkipBlank,
+     * the blank digits are skipped, up to the end of the frame.
+     */
+    void advanceDigit(const T_PATTERN* patterns, const uint8_t* brightnesses) {
+      ace_common::incrementMod(mCurrentDigit, T_DIGITS);
+      if (! kSkipBlank) return;
+      while (mCurrentDigit != 0
+          && ! isDigitLit(patterns, brightnesses, mCurrentDigit)) {
         ace_common::incrementMod(mCurrentDigit, T_DIGITS);
-        mCurrentSubField = 0;
       }
     }
 
     /**
-     * Transfer the global brightness to the per-digit brightness and update the
-     * appropriate flags.
+     * Count the lit digits at the start of a frame, for
+     * kScanningOptionSkipBlank, and move mCurrentDigit to the first one.
+     * Clears the display when the last lit digit becomes blank. Return false
+     * if all digits are blank, so that nothing is drawn in this frame.
      */
-    void updateBrightness() {
-      if (isBrightnessDirty()) {
-        for (uint8_t i = 0; i < T_DIGITS; i++) {
-          setBrightnessAt(i, getBrightness());
+    bool startLitFrame(
+        const T_PATTERN* patterns, const uint8_t* brightnesses) {
+      uint8_t numLitDigits = 0;
+      for (uint8_t i = 0; i < T_DIGITS; i++) {
+        if (isDigitLit(patterns, brightnesses, i)) numLitDigits++;
+      }
+
+      // Divide only when the number of lit digits changes.
+      if (numLitDigits != this->numLitDigits()) {
+        if (numLitDigits == 0) {
+          ledMatrix().clear();
+          mPrevDigit = T_DIGITS; // force the next draw()
+          const uint32_t frameMicros = getMicrosPerFrame();
+          this->setLitDigits(0,
+              (frameMicros > 0xFFFF) ? 0xFFFF : (uint16_t) frameMicros);
+        } else {
+          this->setLitDigits(numLitDigits,
+              (uint32_t) mMicrosPerField * T_DIGITS / numLitDigits);
         }
+      }
+      if (numLitDigits == 0) return false;
 
-        // Clear the global brightness dirty flag.
-        clearBrightnessDirty();
+      while (! isDigitLit(patterns, brightnesses, mCurrentDigit)) {
+        mCurrentDigit++;
       }
+      return true;
+    }
+
+    /**
+     * Return the number of subfields (or BAM units) during which the digit at
+     * `pos` is on in the current frame, after the fade of kScanningOptionFade
+     * and the dithering of kScanningOptionDither.
+     */
+    uint8_t frameLevel(const uint8_t* brightnesses, uint8_t pos) const {
+      return this->ditherLevel(this->fadedBrightness(brightnesses, pos));
+    }
+
+    /**
+     * Return true if the digit at `pos` is not blank in the current frame.
+     * The brightnesses are used only if T_SUBFIELDS > 1. A digit whose
+     * dithered level is 0 in this frame is blank, because
+     * displayCurrentFieldModulated() would not turn it on.
+     */
+    bool isDigitLit(
+        const T_PATTERN* patterns,
+        const uint8_t* brightnesses,
+        uint8_t pos) const {
+      if (patterns[pos] == 0) return false;
+      return T_SUBFIELDS <= 1 || frameLevel(brightnesses, pos) != 0;
+    }
+
+    /**
+     * The T_TIMER callback. Renders a field, then sets the time until the
+     * next interrupt to the duration of that field.
+     */
+    static void timerCallback(void* context) {
+      ScanningModule* module = static_cast<ScanningModule*>(context);
+      module->renderFieldNow();
+      T_TIMER::setPeriodMicros(module->getMicrosUntilNextField());
     }
 
   private:
     // The ordering of the fields below partially motivated to save memory on
     // 32-bit processors.
 
-    /** LedMatrixBase instance that knows how to set and unset LED segments. */
-    const T_LM& mLedMatrix;
+    /** Deadline in micros of the next call to renderFieldNow(). */
+    uint32_t mNextFieldMicros;
 
     /** Pattern for each digit. */
-    uint8_t mPatterns[T_DIGITS];
-
-    /** Brightness for each digit. Unused if T_SUBFIELDS <= 1. */
-    uint8_t mBrightnesses[T_DIGITS];
+    T_PATTERN mPatterns[T_DIGITS];
 
     //-----------------------------------------------------------------------
     // Variables needed by renderFieldWhenReady() to render frames and fields at
@@ -313,9 +1273,6 @@ class ScanningModule : public LedModule {
     /** Number of micros between 2 successive calls to renderFieldNow(). */
     uint16_t mMicrosPerField;
 
-    /** Timestamp in micros of the last call to renderFieldNow(). */
-    uint16_t mLastRenderFieldMicros;
-
     /** Number of full frames (all digits) rendered per second. */
     uint8_t const mFramesPerSecond;
 
@@ -324,12 +1281,10 @@ class ScanningModule : public LedModule {
     // and PWM of a single digit.
     //-----------------------------------------------------------------------
 
-    /** Dirty flag for any of the digit-specific brightness. */
-    bool mIsDigitBrightnessDirty;
-
     /**
      * Within the renderFieldNow() method, mCurrentDigit is the current
-     * digit that is being drawn. It is incremented to the next digit just
+     * digit that is being drawn, or the current segment with
+     * kScanningOptionSegmentMajor. It is incremented to the next digit just
      * before returning from that method.
      */
     uint8_t mCurrentDigit;
@@ -342,19 +1297,6 @@ class ScanningModule : public LedModule {
      * digit.
      */
     uint8_t mPrevDigit;
-
-    /**
-     * Used by displayCurrentFieldModulated() and subclasses generated by
-     * fast_driver.py.
-     */
-    uint8_t mCurrentSubField;
-
-    /**
-     * The segment pattern that is currently displaying on the LED. Used to
-     * optimize the displayCurrentFieldModulated() method if the current
-     * pattern is the same as the previous pattern.
-     */
-    uint8_t mPattern;
 };
 
 }
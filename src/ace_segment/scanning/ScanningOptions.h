@@ -0,0 +1,509 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef ACE_SEGMENT_SCANNING_OPTIONS_H
+#define ACE_SEGMENT_SCANNING_OPTIONS_H
+
+#include <stdint.h>
+#include <string.h> // memcpy(), memset()
+#include "../hw/barrier.h" // memoryBarrier()
+
+namespace ace_segment {
+
+// Bit flags for the T_OPTIONS template parameter of ScanningModule and the
+// modules derived from it (DirectModule, DirectFast4Module, HybridModule,
+// Hc595Module). Multiple options are combined using the '|' operator.
+
+/**
+ * Render from a separate front buffer. The application writes the patterns
+ * into the back buffer using setPatternAt() and similar methods, then calls
+ * ScanningModule::commit(), which copies the back buffer into a second front
+ * buffer. The renderer switches to that front buffer at the next frame
+ * boundary, so that every frame shows a consistent set of patterns without
+ * disabling interrupts in the application, and without copying anything in
+ * the renderer. Uses 2 front buffers of T_DIGITS patterns, plus T_DIGITS
+ * brightness levels each if T_SUBFIELDS > 1.
+ */
+static const uint16_t kScanningOptionDoubleBuffer = 0x0001;
+
+/**
+ * Used only by Hc595Module. The digits are wired in their logical order, so no
+ * remapArray is passed into the constructor. This omits the array of T_DIGITS
+ * bytes which holds the inverted remap array. A remapArray passed into the
+ * constructor is ignored.
+ */
+static const uint16_t kScanningOptionNoRemap = 0x0002;
+
+/**
+ * Use bit angle modulation (BAM) instead of linear PWM for the brightness
+ * control of ScanningModule. T_SUBFIELDS becomes the number of bits of the
+ * brightness, from 1 to 8, so that the brightness ranges from 0 to
+ * `(1 << T_SUBFIELDS) - 1`. Each digit is rendered in T_SUBFIELDS weighted
+ * subfields, whose durations are 1, 2, 4, ... times getMicrosPerField(). For
+ * example, 16 brightness levels need 4 subfields per digit instead of 16.
+ *
+ * The durations of the fields are no longer equal. renderFieldWhenReady()
+ * handles this automatically. An interrupt handler which calls
+ * renderFieldNow() must program the delay to the next interrupt using
+ * ScanningModule::getMicrosUntilNextField().
+ */
+static const uint16_t kScanningOptionBitAngle = 0x0004;
+
+/**
+ * Render from a scan plan, a list of (digit, pattern, hold count) entries
+ * which is built from the patterns and brightness levels by commit(), instead
+ * of from a copy of them. Each renderFieldNow()
+ * then only counts down the hold count of the current entry, and calls
+ * LedMatrix::draw() when the next entry starts, so that its duration no longer
+ * depends on the brightness and the patterns. Requires
+ * kScanningOptionDoubleBuffer. Not supported with kScanningOptionBitAngle.
+ */
+static const uint16_t kScanningOptionScanPlan = 0x0008;
+
+/**
+ * Catch-up policy of renderFieldWhenReady(). If a poll comes so late that the
+ * deadline of the following field has also passed, render the missed fields
+ * back-to-back on the following polls, so that the average frame rate is
+ * preserved. The default is to skip the missed fields, and to restart the
+ * schedule from the late poll. A backlog of more than one frame is always
+ * skipped.
+ */
+static const uint16_t kScanningOptionCatchUpBurst = 0x0010;
+
+/**
+ * Keep statistics of the lateness of renderFieldWhenReady(), available through
+ * ScanningModule::getNumLateFields() and getMaxLateMicros(), at the cost of 4
+ * bytes of RAM.
+ */
+static const uint16_t kScanningOptionLateStats = 0x0020;
+
+/**
+ * Omit the blank digits from the scan. A digit is blank if its pattern is 0,
+ * or if its brightness is 0 when T_SUBFIELDS > 1. The digits which are lit
+ * are counted at the start of each frame, and share the whole frame, so that
+ * they stay on longer and look brighter at the same frame rate. The field
+ * duration returned by ScanningModule::getMicrosUntilNextField() is stretched
+ * by the same factor, so an interrupt handler which reprograms its timer with
+ * that value runs proportionally less often. If all digits are blank, the
+ * display is cleared once, and LedMatrix::draw() is no longer called until a
+ * digit is lit again, with only one check per frame. Costs 3 bytes of RAM.
+ * Not supported with kScanningOptionScanPlan.
+ */
+static const uint16_t kScanningOptionSkipBlank = 0x0040;
+
+/**
+ * Scan by segment instead of by digit, like the old SplitSegmentDriver. The
+ * LedMatrix is wired with the 8 segments as its groups and the digits as its
+ * elements, so each of the 8 fields of a frame turns on one segment across all
+ * digits. A frame then has 8 fields regardless of the number of digits, which
+ * doubles the duty cycle of a 16-digit display, or halves the rate of
+ * renderFieldNow() at the same duty cycle. The patterns are transposed into a
+ * cache of 8 digit bit patterns at the start of each frame, for the digits
+ * which changed only. With more than 8 digits, LedMatrix::draw() receives a
+ * 16-bit element pattern, which is supported by a LedMatrixDirect whose
+ * T_PATTERN is uint16_t. DirectModule selects it automatically. Supports at
+ * most 16 digits. Requires T_SUBFIELDS == 1, because the brightness of a single
+ * digit cannot be controlled, and is not supported with the other rendering
+ * options (kScanningOptionBitAngle, kScanningOptionScanPlan,
+ * kScanningOptionSkipBlank).
+ */
+static const uint16_t kScanningOptionSegmentMajor = 0x0080;
+
+/**
+ * Add a brightness level to each segment of each digit, so that, for example,
+ * the decimal point or colon can be dimmed relative to the rest of the digit,
+ * using ScanningModule::setSegmentBrightness() and setSegmentBrightnessAt().
+ * A segment is on during the subfields which are below both the brightness
+ * of its digit and its own brightness, i.e. it shows the lower of the 2
+ * levels. The levels are stored as T_SUBFIELDS threshold masks per digit,
+ * rebuilt when a level is set, so that renderFieldNow() only masks the digit
+ * pattern and still calls LedMatrix::draw() at most once per field. Costs
+ * `T_DIGITS * T_SUBFIELDS` bytes of RAM. Requires T_SUBFIELDS > 1. The masks
+ * are not double buffered. Not supported with kScanningOptionBitAngle or
+ * kScanningOptionScanPlan.
+ */
+static const uint16_t kScanningOptionSegmentBrightness = 0x0100;
+
+/**
+ * Add kScanningDitherBits fractional bits to the brightness of each digit,
+ * using temporal dithering. A digit whose brightness falls between 2 levels of
+ * the subfield modulation alternates between those levels from frame to
+ * frame, following an ordered pattern which spreads the higher level evenly
+ * over each cycle of `1 << kScanningDitherBits` frames. The number of
+ * brightness levels becomes 8 times larger, at the same
+ * getFieldsPerSecond(), and ScanningModule::kMaxBrightness is scaled
+ * accordingly. Works with linear PWM and kScanningOptionBitAngle, and costs 1
+ * byte of RAM. A high frame rate (e.g. 120 Hz) keeps the alternation
+ * invisible. Requires T_SUBFIELDS > 1, and a maximum undithered brightness of
+ * at most 31. Not supported with kScanningOptionScanPlan.
+ */
+static const uint16_t kScanningOptionDither = 0x0200;
+
+/** Number of fractional bits of brightness added by kScanningOptionDither. */
+static const uint8_t kScanningDitherBits = 3;
+
+/**
+ * Fade the brightness of each digit towards its target, inside the renderer,
+ * once per frame. The brightness set by ScanningModule::setBrightnessAt()
+ * becomes the target, approached by the step set by setFadeStepAt(), in units
+ * of 1/16 of a brightness level per frame. A digit can also pulse between 0
+ * and its target with setPulseAt(), like the old PulseStyler. Fades and pulses
+ * then run without any help from loop(). Costs about 3 bytes of RAM per
+ * digit. Requires T_SUBFIELDS > 1. Not supported with kScanningOptionScanPlan.
+ */
+static const uint16_t kScanningOptionFade = 0x0400;
+
+/**
+ * Interleave the subfields of the digits: render subfield 0 of every digit,
+ * then the next subfield of every digit, and so on, instead of all subfields
+ * of digit 0 before digit 1. With linear PWM, the subfields are visited in
+ * bit-reversed order (0, 4, 2, 6, 1, 5, 3, 7 for 8 subfields), so that the
+ * on-time of a digit is split into pulses spread across the frame, and a digit
+ * at full brightness is refreshed T_SUBFIELDS times per frame. A lower
+ * framesPerSecond, and a lower interrupt rate, then gives the same flicker.
+ * With kScanningOptionBitAngle, the subfields are visited in their natural
+ * order. Requires T_SUBFIELDS > 1. Not supported with kScanningOptionScanPlan
+ * or kScanningOptionSkipBlank.
+ */
+static const uint16_t kScanningOptionInterleave = 0x0800;
+
+namespace internal {
+
+/**
+ * Statistics of the lateness of renderFieldWhenReady(), enabled by
+ * kScanningOptionLateStats. ScanningModule inherits from this class privately,
+ * so that the disabled specialization is optimized away by the empty base
+ * class optimization.
+ *
+ * @tparam T_ENABLED true if kScanningOptionLateStats is selected
+ */
+template <bool T_ENABLED>
+class ScanningLateStats {
+  protected:
+    /** Clear the statistics. */
+    void resetLateStats() {
+      mNumLateFields = 0;
+      mMaxLateMicros = 0;
+    }
+
+    /**
+     * Record that a field was rendered `lateMicros` after its deadline. The
+     * field is counted as late if it missed its deadline by at least
+     * `microsPerField`, i.e. by a whole field.
+     */
+    void recordLateness(uint32_t lateMicros, uint16_t microsPerField) {
+      if (lateMicros >= microsPerField && mNumLateFields != 0xFFFF) {
+        mNumLateFields++;
+      }
+      const uint16_t late = (lateMicros > 0xFFFF) ? 0xFFFF : lateMicros;
+      if (late > mMaxLateMicros) mMaxLateMicros = late;
+    }
+
+    /** Return the number of late fields, saturated at 65535. */
+    uint16_t numLateFields() const { return mNumLateFields; }
+
+    /** Return the worst lateness in micros, saturated at 65535. */
+    uint16_t maxLateMicros() const { return mMaxLateMicros; }
+
+  private:
+    uint16_t mNumLateFields;
+    uint16_t mMaxLateMicros;
+};
+
+/** Specialization used when kScanningOptionLateStats is not selected. */
+template <>
+class ScanningLateStats<false> {
+  protected:
+    void resetLateStats() {}
+
+    void recordLateness(uint32_t /*lateMicros*/, uint16_t /*microsPerField*/) {}
+
+    uint16_t numLateFields() const { return 0; }
+
+    uint16_t maxLateMicros() const { return 0; }
+};
+
+/**
+ * Storage of the frame counter of kScanningOptionDither. ScanningModule
+ * inherits from this class privately, so that the disabled specialization is
+ * optimized away by the empty base class optimization.
+ *
+ * @tparam T_ENABLED true if kScanningOptionDither is selected
+ */
+template <bool T_ENABLED>
+class ScanningDither {
+  protected:
+    /** Restart the dither pattern. */
+    void resetDither() { mDitherFrame = 0; }
+
+    /** Move the dither pattern to the next frame. */
+    void advanceDither() { mDitherFrame++; }
+
+    /**
+     * Return the subfield brightness of the current frame, for a brightness
+     * with kScanningDitherBits fractional bits. The fraction is compared to
+     * the bit-reversed frame counter, so that, for example, a fraction of 1/2
+     * alternates every frame, instead of every 4 frames.
+     */
+    uint8_t ditherLevel(uint8_t brightness) const {
+      const uint8_t frame = mDitherFrame;
+      const uint8_t threshold = ((frame & 0x1) << 2)
+          | (frame & 0x2)
+          | ((frame & 0x4) >> 2);
+      const uint8_t fraction = brightness & ((1 << kScanningDitherBits) - 1);
+      return (brightness >> kScanningDitherBits)
+          + ((fraction > threshold) ? 1 : 0);
+    }
+
+  private:
+    uint8_t mDitherFrame;
+};
+
+/** Specialization used when kScanningOptionDither is not selected. */
+template <>
+class ScanningDither<false> {
+  protected:
+    void resetDither() {}
+
+    void advanceDither() {}
+
+    uint8_t ditherLevel(uint8_t brightness) const { return brightness; }
+};
+
+/**
+ * Storage of the number of lit digits of the current frame, used by
+ * kScanningOptionSkipBlank. ScanningModule inherits from this class privately,
+ * so that the disabled specialization is optimized away by the empty base
+ * class optimization.
+ *
+ * @tparam T_ENABLED true if kScanningOptionSkipBlank is selected
+ */
+template <bool T_ENABLED>
+class ScanningSkipBlank {
+  protected:
+    /**
+     * Set the number of lit digits of the current frame, and the duration of
+     * each of their fields.
+     */
+    void setLitDigits(uint8_t numLitDigits, uint16_t microsPerLitField) {
+      mNumLitDigits = numLitDigits;
+      mMicrosPerLitField = microsPerLitField;
+    }
+
+    /** Return the number of lit digits of the current frame. */
+    uint8_t numLitDigits() const { return mNumLitDigits; }
+
+    /**
+     * Return the duration of the fields of the current frame, or of the whole
+     * frame if all digits are blank.
+     */
+    uint16_t microsPerLitField() const { return mMicrosPerLitField; }
+
+  private:
+    uint16_t mMicrosPerLitField;
+    uint8_t mNumLitDigits;
+};
+
+/** Specialization used when kScanningOptionSkipBlank is not selected. */
+template <>
+class ScanningSkipBlank<false> {
+  protected:
+    void setLitDigits(uint8_t /*numLitDigits*/, uint16_t /*microsPerField*/) {}
+
+    uint8_t numLitDigits() const { return 0; }
+
+    uint16_t microsPerLitField() const { return 0; }
+};
+
+/**
+ * The arrays of the front buffer of ScanningFrontBuffer: T_DIGITS patterns,
+ * followed by T_NUM_BRIGHTNESSES brightness levels.
+ *
+ * @tparam T_PATTERN type of the segment pattern of one digit
+ * @tparam T_DIGITS number of digits
+ * @tparam T_NUM_BRIGHTNESSES number of brightness levels, T_DIGITS or 0
+ */
+template <typename T_PATTERN, uint8_t T_DIGITS, uint8_t T_NUM_BRIGHTNESSES>
+struct FrontStorage {
+  T_PATTERN* patterns() { return mPatterns; }
+  const T_PATTERN* patterns() const { return mPatterns; }
+  uint8_t* brightnesses() { return mBrightnesses; }
+  const uint8_t* brightnesses() const { return mBrightnesses; }
+
+  T_PATTERN mPatterns[T_DIGITS];
+  uint8_t mBrightnesses[T_NUM_BRIGHTNESSES];
+};
+
+/** Specialization without brightness levels, used if T_SUBFIELDS == 1. */
+template <typename T_PATTERN, uint8_t T_DIGITS>
+struct FrontStorage<T_PATTERN, T_DIGITS, 0> {
+  T_PATTERN* patterns() { return mPatterns; }
+  const T_PATTERN* patterns() const { return mPatterns; }
+  uint8_t* brightnesses() { return nullptr; }
+  const uint8_t* brightnesses() const { return nullptr; }
+
+  T_PATTERN mPatterns[T_DIGITS];
+};
+
+/**
+ * Storage and logic of the front buffers used by kScanningOptionDoubleBuffer.
+ * ScanningModule inherits from this class privately, so that the disabled
+ * specialization is optimized away by the empty base class optimization.
+ *
+ * Each front buffer holds the patterns and, if T_SUBFIELDS > 1, the per-digit
+ * brightness levels, so that a commit() changes both in the same frame. There
+ * are 2 of them. commit() copies the back buffer into the one which is not
+ * rendered, in the calling context. The renderer then switches to it at the
+ * next frame boundary by storing a single byte, which is atomic even on AVR.
+ * The renderer never reads the back buffer, so the application may write it
+ * at any time.
+ *
+ * @tparam T_PATTERN type of the segment pattern of one digit
+ * @tparam T_DIGITS number of digits
+ * @tparam T_SUBFIELDS number of subfields per digit
+ * @tparam T_ENABLED true if kScanningOptionDoubleBuffer is selected
+ */
+template <
+    typename T_PATTERN,
+    uint8_t T_DIGITS,
+    uint8_t T_SUBFIELDS,
+    bool T_ENABLED>
+class ScanningFrontBuffer {
+  public:
+    /**
+     * Blank the front buffers and cancel any pending commit. Must be called
+     * before the renderer is started.
+     */
+    void resetFront() {
+      memset(mFronts, 0, sizeof(mFronts));
+      mFrontIndex = 0;
+      mNextFrontIndex = 0;
+    }
+
+    /** Return the patterns which should be rendered. */
+    const T_PATTERN* frontPatterns(const T_PATTERN* /*backPatterns*/) const {
+      return mFronts[mFrontIndex].patterns();
+    }
+
+    /**
+     * Return the per-digit brightness levels which should be rendered. Valid
+     * only if T_SUBFIELDS > 1.
+     */
+    const uint8_t* frontBrightnesses(
+        const uint8_t* /*backBrightnesses*/) const {
+      return mFronts[mFrontIndex].brightnesses();
+    }
+
+    /**
+     * Copy the back buffer into the next front buffer, and publish it. Called
+     * by the application after all the digits of the next frame were
+     * written. Return false without doing anything if the previous commit has
+     * not been picked up by the renderer yet.
+     */
+    bool requestFrontCommit(
+        const T_PATTERN* backPatterns,
+        const uint8_t* backBrightnesses
+    ) {
+      if (isFrontCommitPending()) return false;
+
+      uint8_t next = mFrontIndex ^ 1;
+      FrontStorage<T_PATTERN, T_DIGITS, kNumBrightnesses>& front =
+          mFronts[next];
+      memcpy(front.patterns(), backPatterns, T_DIGITS * sizeof(T_PATTERN));
+      if (kNumBrightnesses > 0) {
+        memcpy(front.brightnesses(), backBrightnesses, kNumBrightnesses);
+      }
+      memoryBarrier(); // front buffer written before the index
+      mNextFrontIndex = next;
+      return true;
+    }
+
+    /** Return true if the next front buffer has not been picked up yet. */
+    bool isFrontCommitPending() const {
+      return mNextFrontIndex != mFrontIndex;
+    }
+
+    /**
+     * Switch to the next front buffer if a commit is pending. Called by the
+     * renderer at a frame boundary.
+     */
+    void applyFrontCommit() {
+      uint8_t next = mNextFrontIndex;
+      if (next == mFrontIndex) return;
+      memoryBarrier(); // index read before the front buffer
+      mFrontIndex = next;
+    }
+
+  private:
+    /** Number of brightness levels in a front buffer. */
+    static const uint8_t kNumBrightnesses = (T_SUBFIELDS > 1) ? T_DIGITS : 0;
+
+    /** Front patterns, followed by the front brightness levels. */
+    FrontStorage<T_PATTERN, T_DIGITS, kNumBrightnesses> mFronts[2];
+
+    /** Index of the rendered front buffer. Written only by the renderer. */
+    volatile uint8_t mFrontIndex;
+
+    /**
+     * Index of the front buffer to render from the next frame. Written only
+     * by the application. Equal to mFrontIndex if no commit is pending.
+     */
+    volatile uint8_t mNextFrontIndex;
+};
+
+/**
+ * Specialization used when kScanningOptionDoubleBuffer is not selected. The
+ * renderer reads the patterns and brightness levels written by the
+ * application directly.
+ */
+template <typename T_PATTERN, uint8_t T_DIGITS, uint8_t T_SUBFIELDS>
+class ScanningFrontBuffer<T_PATTERN, T_DIGITS, T_SUBFIELDS, false> {
+  public:
+    void resetFront() {}
+
+    const T_PATTERN* frontPatterns(const T_PATTERN* backPatterns) const {
+      return backPatterns;
+    }
+
+    const uint8_t* frontBrightnesses(const uint8_t* backBrightnesses) const {
+      return backBrightnesses;
+    }
+
+    bool requestFrontCommit(
+        const T_PATTERN* /*backPatterns*/,
+        const uint8_t* /*backBrightnesses*/
+    ) {
+      return true;
+    }
+
+    bool isFrontCommitPending() const { return false; }
+
+    void applyFrontCommit() {}
+};
+
+} // namespace internal
+} // namespace ace_segment
+
+#endif
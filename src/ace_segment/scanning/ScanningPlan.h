@@ -0,0 +1,252 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_SCANNING_PLAN_H
+#define ACE_SEGMENT_SCANNING_PLAN_H
+
+#include <stdint.h>
+#include "../hw/barrier.h" // memoryBarrier()
+
+namespace ace_segment {
+namespace internal {
+
+/**
+ * One step of the scan plan: draw `pattern` on digit `group`, then keep it on
+ * for `hold` calls to renderFieldNow().
+ *
+ * @tparam T_PATTERN type of the segment pattern of one digit
+ */
+template <typename T_PATTERN>
+struct ScanPlanEntry {
+  uint8_t group;
+  T_PATTERN pattern;
+  uint8_t hold;
+};
+
+/**
+ * The brightness levels of the 2 plans of a ScanningPlan, which are rendered
+ * while their plan is the current one. ScanningPlan inherits from this class
+ * privately, so that the specialization for T_NUM == 0 is optimized away by
+ * the empty base class optimization.
+ *
+ * @tparam T_NUM number of brightness levels, T_DIGITS or 0 if T_SUBFIELDS == 1
+ */
+template <uint8_t T_NUM>
+class ScanningPlanBrightnesses {
+  protected:
+    uint8_t* planBrightnesses(uint8_t plan) { return mBrightnesses[plan]; }
+
+    const uint8_t* planBrightnesses(uint8_t plan) const {
+      return mBrightnesses[plan];
+    }
+
+  private:
+    uint8_t mBrightnesses[2][T_NUM];
+};
+
+/** Specialization used when T_SUBFIELDS == 1. */
+template <>
+class ScanningPlanBrightnesses<0> {
+  protected:
+    uint8_t* planBrightnesses(uint8_t /*plan*/) { return nullptr; }
+
+    const uint8_t* planBrightnesses(uint8_t /*plan*/) const {
+      return nullptr;
+    }
+};
+
+/**
+ * The scan plan used by kScanningOptionScanPlan, which replaces the
+ * ScanningFrontBuffer of kScanningOptionDoubleBuffer. The patterns and
+ * brightness levels are converted into a list of at most 2 entries per digit:
+ * the pattern for `brightness` subfields, then a blank for the remaining
+ * subfields. A digit which is blank or fully on needs only one entry.
+ * Rendering then only steps through this list.
+ *
+ * There are 2 plans. commit() builds the next plan in the calling context,
+ * while the renderer steps through the current one. The renderer then switches
+ * to the next plan at the following frame boundary by storing a single byte,
+ * so that the cost of building the plan is never paid inside an ISR.
+ *
+ * @tparam T_PATTERN type of the segment pattern of one digit
+ * @tparam T_DIGITS number of digits
+ * @tparam T_SUBFIELDS number of PWM subfields per digit
+ */
+template <typename T_PATTERN, uint8_t T_DIGITS, uint8_t T_SUBFIELDS>
+class ScanningPlan :
+    private ScanningPlanBrightnesses<(T_SUBFIELDS > 1) ? T_DIGITS : 0> {
+  public:
+    /**
+     * Blank the display by creating a plan with one blank entry per digit,
+     * and cancel any pending commit. Must be called before the renderer is
+     * started.
+     */
+    void resetFront() {
+      mPlanIndex = 0;
+      mNextPlanIndex = 0;
+      mPlanSizes[0] = 0;
+      uint8_t* brightnesses = this->planBrightnesses(0);
+      for (uint8_t i = 0; i < T_DIGITS; ++i) {
+        addEntry(0, i, 0, T_SUBFIELDS);
+        if (T_SUBFIELDS > 1) brightnesses[i] = 0;
+      }
+      mCursor = 0;
+      mHold = 0;
+    }
+
+    /**
+     * Build the next plan from the back buffer, and publish it. Called by the
+     * application. Return false without doing anything if the previous plan
+     * has not been picked up by the renderer yet.
+     *
+     * @param backPatterns patterns of each digit
+     * @param backBrightnesses brightness of each digit, or nullptr if
+     *    T_SUBFIELDS == 1
+     */
+    bool requestFrontCommit(
+        const T_PATTERN* backPatterns,
+        const uint8_t* backBrightnesses
+    ) {
+      if (isFrontCommitPending()) return false;
+
+      uint8_t next = mPlanIndex ^ 1;
+      buildPlan(next, backPatterns, backBrightnesses);
+      memoryBarrier(); // plan written before the index
+      mNextPlanIndex = next;
+      return true;
+    }
+
+    /** Return true if the next plan has not been picked up yet. */
+    bool isFrontCommitPending() const {
+      return mNextPlanIndex != mPlanIndex;
+    }
+
+    /**
+     * Return the brightness levels of the current plan, i.e. of the last
+     * commit() applied by the renderer, or nullptr if T_SUBFIELDS == 1.
+     */
+    const uint8_t* frontBrightnesses(
+        const uint8_t* /*backBrightnesses*/) const {
+      return this->planBrightnesses(mPlanIndex);
+    }
+
+    /** Return true if the next renderFieldNow() starts a new frame. */
+    bool isPlanAtFrameStart() const {
+      return mCursor == 0 && mHold == 0;
+    }
+
+    /**
+     * Switch to the next plan if a commit is pending. Called by the renderer
+     * at a frame boundary. The plan was already built by
+     * requestFrontCommit().
+     */
+    void applyFrontCommit() {
+      uint8_t next = mNextPlanIndex;
+      if (next == mPlanIndex) return;
+      memoryBarrier(); // index read before the plan
+      mPlanIndex = next;
+    }
+
+    /**
+     * Advance the plan by one field. Return the entry which must be drawn
+     * now, or nullptr if the current entry is still being held.
+     */
+    const ScanPlanEntry<T_PATTERN>* stepPlan() {
+      if (mHold != 0) {
+        mHold--;
+        return nullptr;
+      }
+
+      const uint8_t plan = mPlanIndex;
+      const ScanPlanEntry<T_PATTERN>* entry = &mPlans[plan][mCursor];
+      mHold = entry->hold - 1;
+      mCursor++;
+      if (mCursor >= mPlanSizes[plan]) mCursor = 0;
+      return entry;
+    }
+
+  private:
+    /** A digit needs a second entry only if its brightness is partial. */
+    static const uint8_t kMaxEntries =
+        (T_SUBFIELDS > 1) ? 2 * T_DIGITS : T_DIGITS;
+
+    /** Build the plan at index `plan` from the back buffer. */
+    void buildPlan(
+        uint8_t plan,
+        const T_PATTERN* backPatterns,
+        const uint8_t* backBrightnesses
+    ) {
+      mPlanSizes[plan] = 0;
+      uint8_t* brightnesses = this->planBrightnesses(plan);
+      for (uint8_t i = 0; i < T_DIGITS; ++i) {
+        const T_PATTERN pattern = backPatterns[i];
+        const uint8_t brightness = (T_SUBFIELDS > 1)
+            ? backBrightnesses[i]
+            : T_SUBFIELDS;
+        if (T_SUBFIELDS > 1) brightnesses[i] = brightness;
+        if (pattern == 0 || brightness == 0) {
+          addEntry(plan, i, 0, T_SUBFIELDS);
+        } else if (brightness >= T_SUBFIELDS) {
+          addEntry(plan, i, pattern, T_SUBFIELDS);
+        } else {
+          addEntry(plan, i, pattern, brightness);
+          addEntry(plan, i, 0, T_SUBFIELDS - brightness);
+        }
+      }
+    }
+
+    void addEntry(
+        uint8_t plan, uint8_t group, T_PATTERN pattern, uint8_t hold) {
+      ScanPlanEntry<T_PATTERN>& entry = mPlans[plan][mPlanSizes[plan]++];
+      entry.group = group;
+      entry.pattern = pattern;
+      entry.hold = hold;
+    }
+
+    /** The current plan and the next plan, each the entries of one frame. */
+    ScanPlanEntry<T_PATTERN> mPlans[2][kMaxEntries];
+
+    /** Number of valid entries in each of mPlans. */
+    uint8_t mPlanSizes[2];
+
+    /** Index of the plan being rendered. Written only by the renderer. */
+    volatile uint8_t mPlanIndex;
+
+    /**
+     * Index of the plan to render from the next frame. Written only by the
+     * application. Equal to mPlanIndex if no commit is pending.
+     */
+    volatile uint8_t mNextPlanIndex;
+
+    /** Index of the next entry to draw. */
+    uint8_t mCursor;
+
+    /** Number of remaining fields of the current entry. */
+    uint8_t mHold;
+};
+
+} // namespace internal
+} // namespace ace_segment
+
+#endif
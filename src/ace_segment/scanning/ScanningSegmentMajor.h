@@ -0,0 +1,129 @@
+/*
+MIT License
+
+Copyright (c) 2022 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_SCANNING_SEGMENT_MAJOR_H
+#define ACE_SEGMENT_SCANNING_SEGMENT_MAJOR_H
+
+#include <stdint.h>
+#include <string.h> // memset()
+
+namespace ace_segment {
+namespace internal {
+
+/**
+ * Select the type of the digit bit pattern of a segment: uint8_t for up to 8
+ * digits, uint16_t for up to 16 digits.
+ */
+template <bool T_WIDE>
+struct SegmentMajorBits { typedef uint8_t Type; };
+
+template <>
+struct SegmentMajorBits<true> { typedef uint16_t Type; };
+
+/**
+ * The transposed pattern cache used by kScanningOptionSegmentMajor. Bit `d` of
+ * segmentPattern(s) is set if segment `s` of digit `d` is on, so that one
+ * field can turn on one segment across all digits. ScanningModule inherits
+ * from this class privately, so that the disabled specialization is optimized
+ * away by the empty base class optimization.
+ *
+ * The cache keeps a copy of the digit patterns that it was built from, and
+ * updates only the bits of the digits which changed since the previous frame.
+ * Both copies are written only by the renderer, so the application does not
+ * need to do anything to keep the cache in sync.
+ *
+ * @tparam T_DIGITS number of digits, at most 16
+ * @tparam T_ENABLED true if kScanningOptionSegmentMajor is selected
+ */
+template <uint8_t T_DIGITS, bool T_ENABLED>
+class ScanningSegmentMajor {
+  public:
+    /** Number of segments, which are scanned instead of the digits. */
+    static const uint8_t kNumSegments = 8;
+
+    /** Bit pattern of the digits for a single segment. */
+    typedef typename SegmentMajorBits<(T_DIGITS > 8)>::Type DigitBits;
+
+  protected:
+    /** Blank the cache, matching the patterns blanked by begin(). */
+    void resetSegmentMajor() {
+      memset(mDigitPatterns, 0, sizeof(mDigitPatterns));
+      memset(mSegmentPatterns, 0, sizeof(mSegmentPatterns));
+    }
+
+    /**
+     * Update the cache from `patterns`, toggling only the bits of the
+     * segments which changed.
+     */
+    void updateSegmentMajor(const uint8_t* patterns) {
+      for (uint8_t digit = 0; digit < T_DIGITS; digit++) {
+        const uint8_t pattern = patterns[digit];
+        uint8_t changed = pattern ^ mDigitPatterns[digit];
+        if (changed == 0) continue;
+
+        mDigitPatterns[digit] = pattern;
+        const DigitBits digitBit = (DigitBits) 1 << digit;
+        for (uint8_t segment = 0; changed != 0; segment++) {
+          if (changed & 0x1) mSegmentPatterns[segment] ^= digitBit;
+          changed >>= 1;
+        }
+      }
+    }
+
+    /** Return the digit bit pattern of the given segment. */
+    DigitBits segmentPattern(uint8_t segment) const {
+      return mSegmentPatterns[segment];
+    }
+
+  private:
+    /** Digit bit pattern of each segment. */
+    DigitBits mSegmentPatterns[kNumSegments];
+
+    /** Digit patterns that mSegmentPatterns was built from. */
+    uint8_t mDigitPatterns[T_DIGITS];
+};
+
+/**
+ * Specialization used when kScanningOptionSegmentMajor is not selected.
+ */
+template <uint8_t T_DIGITS>
+class ScanningSegmentMajor<T_DIGITS, false> {
+  public:
+    static const uint8_t kNumSegments = 8;
+
+    typedef uint8_t DigitBits;
+
+  protected:
+    void resetSegmentMajor() {}
+
+    /** Accepts the patterns of any width, since it is never called. */
+    void updateSegmentMajor(const void* /*patterns*/) {}
+
+    DigitBits segmentPattern(uint8_t /*segment*/) const { return 0; }
+};
+
+} // namespace internal
+} // namespace ace_segment
+
+#endif
@@ -36,20 +36,33 @@ namespace testing {
  * @tparam T_DIGITS number of digits supported by this class
  */
 template <uint8_t T_DIGITS>
-class TestableLedModule : public LedModule {
+class TestableLedModule :
+    public BasicLedModule<uint8_t, LedModule::numDirtyBytes(T_DIGITS)> {
+  private:
+    using Super = BasicLedModule<uint8_t, LedModule::numDirtyBytes(T_DIGITS)>;
+
   public:
-    explicit TestableLedModule() : LedModule(mPatterns, T_DIGITS) {}
+    explicit TestableLedModule() : Super(mPatterns, T_DIGITS) {}
 
     void begin() {
-      LedModule::begin();
+      Super::begin();
     }
 
     void end() {
-      LedModule::end();
+      Super::end();
     }
 
     uint8_t* getPatterns() { return mPatterns; }
 
+    // Expose the protected dirty bit methods for unit testing.
+    using Super::setDigitDirty;
+    using Super::clearDigitDirty;
+    using Super::isDigitDirty;
+    using Super::setDigitsDirty;
+    using Super::clearDigitsDirty;
+    using Super::isAnyDigitDirty;
+    using Super::nextDirtyRun;
+
   private:
     uint8_t mPatterns[T_DIGITS + 1]; // + 1 to test overflow
 };
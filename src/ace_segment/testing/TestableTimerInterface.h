@@ -0,0 +1,111 @@
+/*
+MIT License
+
+Copyright (c) 2021 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_TESTABLE_TIMER_INTERFACE_H
+#define ACE_SEGMENT_TESTABLE_TIMER_INTERFACE_H
+
+#include <stdint.h>
+#include "TestableClockInterface.h"
+
+namespace ace_segment {
+namespace testing {
+
+/**
+ * A T_TIMER which runs on the virtual time of TestableClockInterface. The
+ * test calls advanceMicros(), which moves the clock forward and calls the
+ * callback at each expiry of the timer on the way, like the interrupt of a
+ * hardware timer.
+ *
+ * The expiry times follow the periods set by setPeriodMicros(), independent
+ * of the latency set by setLatencyMicros(), which delays only the clock seen
+ * by the callback. This models a hardware counter which keeps running while
+ * the interrupt waits to be serviced, so the test can check the cadence and
+ * the jitter of the rendering.
+ */
+class TestableTimerInterface {
+  public:
+    /** Type of the function called from the timer interrupt. */
+    typedef void (*Callback)(void* context);
+
+    static void attachInterrupt(Callback callback, void* context,
+        uint16_t micros) {
+      sCallback = callback;
+      sContext = context;
+      sPeriodMicros = micros;
+      sNextMicros = TestableClockInterface::sMicros + micros;
+      sNumInterrupts = 0;
+    }
+
+    static void setPeriodMicros(uint16_t micros) {
+      sPeriodMicros = micros;
+    }
+
+    static void detachInterrupt() { sCallback = nullptr; }
+
+    /**
+     * Advance TestableClockInterface by `micros`, calling the callback at each
+     * expiry of the timer, with the clock set to the expiry time plus the
+     * latency.
+     */
+    static void advanceMicros(unsigned long micros) {
+      const unsigned long endMicros = TestableClockInterface::sMicros + micros;
+      while (sCallback != nullptr
+          && (long) (endMicros - sNextMicros) >= 0) {
+        const unsigned long expiryMicros = sNextMicros;
+        TestableClockInterface::setMicros(expiryMicros + sLatencyMicros);
+        ++sNumInterrupts;
+
+        // The period set by the callback starts at this expiry.
+        sCallback(sContext);
+        sNextMicros = expiryMicros + sPeriodMicros;
+      }
+      TestableClockInterface::setMicros(endMicros);
+    }
+
+    /** Set the delay between an expiry and the call to the callback. */
+    static void setLatencyMicros(uint16_t micros) { sLatencyMicros = micros; }
+
+    /** Return true if a callback is attached. */
+    static bool isAttached() { return sCallback != nullptr; }
+
+  public:
+    static Callback sCallback;
+    static void* sContext;
+
+    /** Virtual time of the next expiry. */
+    static unsigned long sNextMicros;
+
+    /** Current period, as set by attachInterrupt() or setPeriodMicros(). */
+    static uint16_t sPeriodMicros;
+
+    static uint16_t sLatencyMicros;
+
+    /** Number of callbacks since attachInterrupt(). */
+    static uint16_t sNumInterrupts;
+};
+
+} // namespace testing
+} // namespace ace_segment
+
+#endif
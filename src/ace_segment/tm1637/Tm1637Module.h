@@ -28,9 +28,14 @@ SOFTWARE.
 #include <string.h> // memset()
 #include <AceCommon.h> // incrementMod()
 #include "../LedModule.h"
+#include "../TimingProbe.h"
+#include "../ShadowBuffer.h"
 
 class Tm1637ModuleTest_flushIncremental;
 class Tm1637ModuleTest_flush;
+class Tm1637ModuleTest_flush_shadow;
+class Tm1637ModuleTest_flushDirty;
+class Tm1637ModuleTest_flushDirty_shadow;
 
 namespace ace_segment {
 
@@ -70,9 +75,23 @@ extern const uint8_t kDigitRemapArray6Tm1637[6];
  *    TM1637, usually one of the classes from the AceTMI library:
  *    SimpleTmi1637Interface or SimpleTmi1637FastInterface.
  * @tparam T_DIGITS number of digits in the LED module (usually 4 or 6)
+ * @tparam T_SHADOW keep a copy of the bytes last sent to the chip, so that
+ *    flush() and flushIncremental() transmit only the bytes which differ
+ *    (default: false)
+ * @tparam T_PROBE (optional) instrumentation policy which times flush(),
+ *    flushIncremental() and flushDirty(), e.g. TimingProbe<> (default:
+ *    NoTimingProbe)
  */
-template <typename T_TMII, uint8_t T_DIGITS>
-class Tm1637Module : public LedModule {
+template <
+    typename T_TMII,
+    uint8_t T_DIGITS,
+    bool T_SHADOW = false,
+    typename T_PROBE = NoTimingProbe
+>
+class Tm1637Module :
+    public LedModule,
+    private T_PROBE,
+    private internal::ShadowBuffer<T_DIGITS + 1, T_SHADOW> {
   public:
 
     /**
@@ -105,6 +124,7 @@ class Tm1637Module : public LedModule {
       memset(mPatterns, 0, T_DIGITS);
       setDisplayOn(true);
       mFlushStage = 0;
+      this->invalidateShadow();
     }
 
     /** Signal end of usage. Currently does nothing. */
@@ -134,42 +154,127 @@ class Tm1637Module : public LedModule {
       return isAnyDigitDirty() || isBrightnessDirty();
     }
 
+    /** Return the T_PROBE which times the flush methods. */
+    T_PROBE& getTimingProbe() { return *this; }
+
+    /** Return the T_PROBE which times the flush methods. */
+    const T_PROBE& getTimingProbe() const { return *this; }
+
     /**
      * Send segment patterns of all digits plus the brightness to the display.
      * Takes about 22 ms using a 100 microsecond delay.
      *
      * The isFlushRequired() method can be used to optimize the number of calls
      * to flush(), but often it is not necessary.
+     *
+     * If T_SHADOW is enabled, only the span of digits between the first and
+     * last digits which differ from the chip is sent, and the brightness is
+     * sent only if it changed.
      */
     void flush() {
-      // Command1: Update the digits using auto incrementing mode.
-      mTmiInterface.startCondition();
-      mTmiInterface.write(kDataCmdAutoAddress);
-      mTmiInterface.stopCondition();
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
 
-      // Command2: Send the LED patterns.
-      mTmiInterface.startCondition();
-      mTmiInterface.write(kAddressCmd);
+      // Find the span of chip positions which must be sent. Without the shadow
+      // copy, this is always the entire module.
+      uint8_t beginPos = T_DIGITS;
+      uint8_t endPos = 0;
       for (uint8_t chipPos = 0; chipPos < T_DIGITS; ++chipPos) {
-        // Remap the logical position used by the controller to the actual
-        // position. For example, if the controller digit 0 appears at physical
-        // digit 2, we need to display the segment pattern given by logical
-        // position 2 when sending the byte to controller digit 0.
-        uint8_t physicalPos = remapLogicalToPhysical(chipPos);
-        uint8_t effectivePattern = mPatterns[physicalPos];
-        mTmiInterface.write(effectivePattern);
+        if (this->isShadowDifferent(chipPos, patternForChipPos(chipPos))) {
+          if (beginPos == T_DIGITS) beginPos = chipPos;
+          endPos = chipPos + 1;
+        }
+      }
+
+      if (beginPos < endPos) {
+        // Command1: Update the digits using auto incrementing mode.
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kDataCmdAutoAddress);
+        mTmiInterface.stopCondition();
+
+        // Command2: Send the LED patterns.
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kAddressCmd | beginPos);
+        for (uint8_t chipPos = beginPos; chipPos < endPos; ++chipPos) {
+          uint8_t effectivePattern = patternForChipPos(chipPos);
+          this->updateShadow(chipPos, effectivePattern);
+          mTmiInterface.write(effectivePattern);
+        }
+        mTmiInterface.stopCondition();
       }
-      mTmiInterface.stopCondition();
 
       // Command3: Update the brightness last. This matches the recommendation
       // given in the Titan Micro TM1637 datasheet. But experimentation shows
       // that things seems to work even if brightness is sent first, before the
       // digit patterns.
-      mTmiInterface.startCondition();
-      mTmiInterface.write(kBrightnessCmd
-          | (mDisplayOn ? kBrightnessLevelOn : 0x0)
-          | (getBrightness() & 0xF));
-      mTmiInterface.stopCondition();
+      uint8_t brightnessCmd = brightnessCommand();
+      if (this->updateShadow(T_DIGITS, brightnessCmd)) {
+        mTmiInterface.startCondition();
+        mTmiInterface.write(brightnessCmd);
+        mTmiInterface.stopCondition();
+      }
+
+      this->validateShadow();
+      clearDigitsDirty();
+      clearBrightnessDirty();
+    }
+
+    /**
+     * Send only the dirty digits, using one auto-increment burst for each run
+     * of consecutive dirty digits in the address order of the chip, followed
+     * by the brightness if it is dirty. When only a few adjacent digits
+     * change, this avoids both the unchanged digits sent by flush() and the
+     * per-digit address commands of flushIncremental(). If T_SHADOW is
+     * enabled, dirty digits which the chip already holds are skipped. The
+     * first call after begin() sends everything through flush(), so that the
+     * shadow copy becomes valid.
+     */
+    void flushDirty() {
+      if (! this->isShadowValid()) {
+        flush();
+        return;
+      }
+
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
+      clearShadowedDigitsDirty();
+
+      bool isDataCmdSent = false;
+      uint8_t beginPos = 0;
+      while (true) {
+        uint8_t endPos = nextDirtyRun(beginPos, T_DIGITS, mRemapArray);
+        if (beginPos == endPos) break;
+
+        // Command1: Update the digits using auto incrementing mode, once for
+        // all the runs.
+        if (! isDataCmdSent) {
+          mTmiInterface.startCondition();
+          mTmiInterface.write(kDataCmdAutoAddress);
+          mTmiInterface.stopCondition();
+          isDataCmdSent = true;
+        }
+
+        // Command2: Send the LED patterns of this run.
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kAddressCmd | beginPos);
+        for (uint8_t chipPos = beginPos; chipPos < endPos; ++chipPos) {
+          uint8_t effectivePattern = patternForChipPos(chipPos);
+          this->updateShadow(chipPos, effectivePattern);
+          mTmiInterface.write(effectivePattern);
+        }
+        mTmiInterface.stopCondition();
+
+        beginPos = endPos;
+      }
+
+      // Command3: Update the brightness last.
+      if (isBrightnessDirty()) {
+        uint8_t brightnessCmd = brightnessCommand();
+        if (this->updateShadow(T_DIGITS, brightnessCmd)) {
+          mTmiInterface.startCondition();
+          mTmiInterface.write(brightnessCmd);
+          mTmiInterface.stopCondition();
+        }
+      }
 
       clearDigitsDirty();
       clearBrightnessDirty();
@@ -209,16 +314,24 @@ class Tm1637Module : public LedModule {
      * separate iterations.
      */
     void flushIncremental() {
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
       if (mFlushStage == T_DIGITS) {
         // Update brightness.
         if (isBrightnessDirty()) {
-          mTmiInterface.startCondition();
-          mTmiInterface.write(kBrightnessCmd
-              | (mDisplayOn ? kBrightnessLevelOn : 0x0)
-              | (getBrightness() & 0xF));
-          mTmiInterface.stopCondition();
+          uint8_t brightnessCmd = brightnessCommand();
+          if (this->updateShadow(T_DIGITS, brightnessCmd)) {
+            mTmiInterface.startCondition();
+            mTmiInterface.write(brightnessCmd);
+            mTmiInterface.stopCondition();
+          }
           clearBrightnessDirty();
         }
+
+        // Since begin() marks every digit dirty, the first full cycle of
+        // flushIncremental() sends every byte, so the shadow copy now matches
+        // the chip.
+        this->validateShadow();
       } else {
         // Remap the logical position used by the controller to the actual
         // position. For example, if the controller digit 0 appears at physical
@@ -227,15 +340,18 @@ class Tm1637Module : public LedModule {
         const uint8_t chipPos = mFlushStage;
         const uint8_t physicalPos = remapLogicalToPhysical(chipPos);
         if (isDigitDirty(physicalPos)) {
-          // Update changed digit.
-          mTmiInterface.startCondition();
-          mTmiInterface.write(kDataCmdFixedAddress);
-          mTmiInterface.stopCondition();
-
-          mTmiInterface.startCondition();
-          mTmiInterface.write(kAddressCmd | chipPos);
-          mTmiInterface.write(mPatterns[physicalPos]);
-          mTmiInterface.stopCondition();
+          uint8_t pattern = mPatterns[physicalPos];
+          if (this->updateShadow(chipPos, pattern)) {
+            // Update changed digit.
+            mTmiInterface.startCondition();
+            mTmiInterface.write(kDataCmdFixedAddress);
+            mTmiInterface.stopCondition();
+
+            mTmiInterface.startCondition();
+            mTmiInterface.write(kAddressCmd | chipPos);
+            mTmiInterface.write(pattern);
+            mTmiInterface.stopCondition();
+          }
           clearDigitDirty(physicalPos);
         }
       }
@@ -276,10 +392,44 @@ class Tm1637Module : public LedModule {
       return mRemapArray ? mRemapArray[pos] : pos;
     }
 
+    /**
+     * Return the pattern to send to controller digit `chipPos`. Remap the
+     * logical position used by the controller to the actual position. For
+     * example, if the controller digit 0 appears at physical digit 2, we need
+     * to display the segment pattern given by logical position 2 when sending
+     * the byte to controller digit 0.
+     */
+    uint8_t patternForChipPos(uint8_t chipPos) const {
+      return mPatterns[remapLogicalToPhysical(chipPos)];
+    }
+
+    /**
+     * Clear the dirty bits of the digits which already match the shadow copy
+     * of the chip. Does nothing if T_SHADOW is disabled.
+     */
+    void clearShadowedDigitsDirty() {
+      if (! T_SHADOW) return;
+      for (uint8_t chipPos = 0; chipPos < T_DIGITS; ++chipPos) {
+        if (! this->isShadowDifferent(chipPos, patternForChipPos(chipPos))) {
+          clearDigitDirty(remapLogicalToPhysical(chipPos));
+        }
+      }
+    }
+
+    /** Return the command byte which sets the current brightness. */
+    uint8_t brightnessCommand() const {
+      return kBrightnessCmd
+          | (mDisplayOn ? kBrightnessLevelOn : 0x0)
+          | (getBrightness() & 0xF);
+    }
+
   private:
     // Give access to mIsDirty and mFlushStage
     friend class ::Tm1637ModuleTest_flushIncremental;
     friend class ::Tm1637ModuleTest_flush;
+    friend class ::Tm1637ModuleTest_flush_shadow;
+    friend class ::Tm1637ModuleTest_flushDirty;
+    friend class ::Tm1637ModuleTest_flushDirty_shadow;
 
     // These come from the TM1637 controller chip datasheet.
     static uint8_t const kDataCmdWriteDisplay = 0b01000000;
@@ -29,6 +29,7 @@ SOFTWARE.
 #include <string.h> // memset()
 #include <Arduino.h> // delayMicroseconds()
 #include "../LedModule.h"
+#include "../TimingProbe.h"
 
 class Tm1638ModuleTest_flushIncremental;
 class Tm1638ModuleTest_flush;
@@ -43,9 +44,17 @@ namespace ace_segment {
  *    interface for TM1638, usually one of the classes from the AceTMI library:
  *    SimpleTmi1638Interface or SimpleTmi1638FastInterface.
  * @tparam T_DIGITS number of digits in the LED module (usually 8)
+ * @tparam T_PROBE (optional) instrumentation policy which times flush(), e.g.
+ *    TimingProbe<> (default: NoTimingProbe)
  */
-template <typename T_TMII, uint8_t T_DIGITS>
-class Tm1638AnodeModule : public LedModule {
+template <
+    typename T_TMII,
+    uint8_t T_DIGITS,
+    typename T_PROBE = NoTimingProbe
+>
+class Tm1638AnodeModule :
+    public LedModule,
+    private T_PROBE {
   public:
 
     /**
@@ -104,6 +113,12 @@ class Tm1638AnodeModule : public LedModule {
       return isAnyDigitDirty() || isBrightnessDirty();
     }
 
+    /** Return the T_PROBE which times the flush methods. */
+    T_PROBE& getTimingProbe() { return *this; }
+
+    /** Return the T_PROBE which times the flush methods. */
+    const T_PROBE& getTimingProbe() const { return *this; }
+
     /**
      * Send segment patterns of all digits plus the brightness to the display.
      *
@@ -121,6 +136,8 @@ class Tm1638AnodeModule : public LedModule {
      * to flush(), but often it is not necessary.
      */
     void flush() {
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
       // Command1: Update the digits using auto incrementing mode.
       mTmiInterface.beginTransaction();
       mTmiInterface.write(kDataCmdAutoAddress);
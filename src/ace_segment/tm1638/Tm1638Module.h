@@ -29,9 +29,11 @@ SOFTWARE.
 #include <string.h> // memset()
 #include <Arduino.h> // delayMicroseconds()
 #include "../LedModule.h"
+#include "../TimingProbe.h"
 
 class Tm1638ModuleTest_flushIncremental;
 class Tm1638ModuleTest_flush;
+class Tm1638ModuleTest_flushDirty;
 
 namespace ace_segment {
 
@@ -60,9 +62,17 @@ extern const uint8_t kDigitRemapArray8Tm1638[8];
  *    interface for TM1638, usually one of the classes from the AceTMI library:
  *    SimpleTmi1638Interface or SimpleTmi1638FastInterface.
  * @tparam T_DIGITS number of digits in the LED module (usually 8)
+ * @tparam T_PROBE (optional) instrumentation policy which times flush() and
+ *    flushDirty(), e.g. TimingProbe<> (default: NoTimingProbe)
  */
-template <typename T_TMII, uint8_t T_DIGITS>
-class Tm1638Module : public LedModule {
+template <
+    typename T_TMII,
+    uint8_t T_DIGITS,
+    typename T_PROBE = NoTimingProbe
+>
+class Tm1638Module :
+    public LedModule,
+    private T_PROBE {
   public:
 
     /**
@@ -123,6 +133,12 @@ class Tm1638Module : public LedModule {
       return isAnyDigitDirty() || isBrightnessDirty();
     }
 
+    /** Return the T_PROBE which times the flush methods. */
+    T_PROBE& getTimingProbe() { return *this; }
+
+    /** Return the T_PROBE which times the flush methods. */
+    const T_PROBE& getTimingProbe() const { return *this; }
+
     /**
      * Send segment patterns of all digits plus the brightness to the display.
      *
@@ -140,6 +156,8 @@ class Tm1638Module : public LedModule {
      * to flush(), but often it is not necessary.
      */
     void flush() {
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
       // Command1: Update the digits using auto incrementing mode.
       mTmiInterface.beginTransaction();
       mTmiInterface.write(kDataCmdAutoAddress);
@@ -174,6 +192,57 @@ class Tm1638Module : public LedModule {
       clearBrightnessDirty();
     }
 
+    /**
+     * Send only the dirty digits, using one auto-increment burst for each run
+     * of consecutive dirty digits in the address order of the chip, followed
+     * by the brightness if it is dirty. When only a few adjacent digits
+     * change, this sends far fewer bytes than flush().
+     */
+    void flushDirty() {
+      internal::TimingProbeScope<T_PROBE> probeScope(getTimingProbe());
+
+      bool isDataCmdSent = false;
+      uint8_t beginPos = 0;
+      while (true) {
+        uint8_t endPos = nextDirtyRun(beginPos, T_DIGITS, mRemapArray);
+        if (beginPos == endPos) break;
+
+        // Command1: Update the digits using auto incrementing mode, once for
+        // all the runs.
+        if (! isDataCmdSent) {
+          mTmiInterface.beginTransaction();
+          mTmiInterface.write(kDataCmdAutoAddress);
+          mTmiInterface.endTransaction();
+          isDataCmdSent = true;
+        }
+
+        // Command2: Send the LED patterns of this run. Each digit occupies 2
+        // bytes of the display memory.
+        mTmiInterface.beginTransaction();
+        mTmiInterface.write(kAddressCmd | (beginPos * 2));
+        for (uint8_t chipPos = beginPos; chipPos < endPos; ++chipPos) {
+          uint8_t physicalPos = remapLogicalToPhysical(chipPos);
+          mTmiInterface.write(mPatterns[physicalPos]);
+          mTmiInterface.write(0x00); // SEG8 and SEG9 not supported
+        }
+        mTmiInterface.endTransaction();
+
+        beginPos = endPos;
+      }
+
+      // Command3: Update the brightness last.
+      if (isBrightnessDirty()) {
+        mTmiInterface.beginTransaction();
+        mTmiInterface.write(kBrightnessCmd
+            | (mDisplayOn ? kBrightnessLevelOn : 0x0)
+            | (getBrightness() & 0xF));
+        mTmiInterface.endTransaction();
+      }
+
+      clearDigitsDirty();
+      clearBrightnessDirty();
+    }
+
     //-----------------------------------------------------------------------
     // Methods related to buttons
     //-----------------------------------------------------------------------
@@ -216,6 +285,7 @@ class Tm1638Module : public LedModule {
   private:
     // Give access to mIsDirty.
     friend class ::Tm1638ModuleTest_flush;
+    friend class ::Tm1638ModuleTest_flushDirty;
 
     // These come from the TM1638 controller chip datasheet.
     static uint8_t const kDataCmdWriteDisplay = 0b01000000;
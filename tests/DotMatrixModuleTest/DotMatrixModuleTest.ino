@@ -0,0 +1,172 @@
+#line 2 "DotMatrixModuleTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2021 Brian T. Park
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/EventLog.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+#include <ace_segment/testing/TestableLedMatrix.h>
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+const uint8_t FRAMES_PER_SECOND = 100;
+
+TestableLedMatrix ledMatrix;
+
+DotMatrixModule<TestableLedMatrix, 8, uint8_t, 1, TestableClockInterface>
+    dotMatrix(ledMatrix, FRAMES_PER_SECOND);
+
+// Each field draws one whole row.
+test(DotMatrixModuleTest, renderFieldNow) {
+  dotMatrix.begin();
+  assertEqual(8, dotMatrix.getFieldsPerFrame());
+  dotMatrix.setPixel(0, 0, true);
+  dotMatrix.setPixel(7, 0, true);
+  dotMatrix.setPixel(3, 1, true);
+  assertTrue(dotMatrix.getPixel(7, 0));
+  assertFalse(dotMatrix.getPixel(6, 0));
+
+  ledMatrix.mEventLog.clear();
+  dotMatrix.renderFieldNow();
+  dotMatrix.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x81,
+      (int) EventType::kLedMatrixDraw, 1, 0x08));
+
+  dotMatrix.end();
+}
+
+// Only the rows which actually change are marked dirty.
+test(DotMatrixModuleTest, dirtyRows) {
+  dotMatrix.begin();
+  dotMatrix.clearRowsDirty();
+  assertFalse(dotMatrix.isAnyRowDirty());
+
+  dotMatrix.setPixel(2, 5, true);
+  dotMatrix.setPixel(2, 5, true);
+  assertTrue(dotMatrix.isRowDirty(5));
+  assertFalse(dotMatrix.isRowDirty(4));
+
+  // Shifting a row which is blank does not dirty it.
+  dotMatrix.clearRowsDirty();
+  dotMatrix.shiftLeft(1);
+  assertEqual(0x02, dotMatrix.getPatternAt(5));
+  assertTrue(dotMatrix.isRowDirty(5));
+  assertFalse(dotMatrix.isRowDirty(0));
+
+  dotMatrix.end();
+}
+
+test(DotMatrixModuleTest, blit) {
+  dotMatrix.begin();
+  dotMatrix.fillPatterns(0xFF);
+
+  // A 3x2 bitmap replaces the pixels under it, and only those.
+  const uint8_t bitmap[] = {0x05, 0x02};
+  dotMatrix.blit(2, 6, bitmap, 3, 2);
+  assertEqual(0xFF, dotMatrix.getPatternAt(5));
+  assertEqual(0xF7, dotMatrix.getPatternAt(6)); // 0b11110111
+  assertEqual(0xEB, dotMatrix.getPatternAt(7)); // 0b11101011
+
+  // Clipped at the left, bottom and right edges.
+  dotMatrix.clear();
+  dotMatrix.blit(-1, 7, bitmap, 3, 2);
+  assertEqual(0x02, dotMatrix.getPatternAt(7));
+  dotMatrix.blit(6, 0, bitmap, 3, 1);
+  assertEqual(0x40, dotMatrix.getPatternAt(0));
+
+  // Entirely outside of the display.
+  dotMatrix.clear();
+  dotMatrix.blit(8, 0, bitmap, 3, 2);
+  dotMatrix.blit(-3, 0, bitmap, 3, 2);
+  dotMatrix.blit(0, -2, bitmap, 3, 2);
+  for (uint8_t y = 0; y < 8; ++y) {
+    assertEqual(0, dotMatrix.getPatternAt(y));
+  }
+
+  dotMatrix.end();
+}
+
+test(DotMatrixModuleTest, shift) {
+  dotMatrix.begin();
+  const uint8_t bitmap[] = {0x81, 0x42};
+  dotMatrix.blit(0, 0, bitmap, 8, 2);
+
+  dotMatrix.shiftRight(1);
+  assertEqual(0x02, dotMatrix.getPatternAt(0));
+  assertEqual(0x84, dotMatrix.getPatternAt(1));
+
+  dotMatrix.shiftDown(6);
+  assertEqual(0, dotMatrix.getPatternAt(0));
+  assertEqual(0x02, dotMatrix.getPatternAt(6));
+  assertEqual(0x84, dotMatrix.getPatternAt(7));
+
+  dotMatrix.shiftUp(7);
+  assertEqual(0x84, dotMatrix.getPatternAt(0));
+  assertEqual(0, dotMatrix.getPatternAt(1));
+
+  dotMatrix.shiftLeft(8);
+  assertEqual(0, dotMatrix.getPatternAt(0));
+
+  dotMatrix.end();
+}
+
+// Scroll a column into the right edge of the display.
+test(DotMatrixModuleTest, setColumn) {
+  dotMatrix.begin();
+  dotMatrix.setColumn(7, 0xA5);
+  assertEqual(0xA5, dotMatrix.getColumn(7));
+  assertEqual(0x80, dotMatrix.getPatternAt(0));
+  assertEqual(0x00, dotMatrix.getPatternAt(1));
+
+  dotMatrix.shiftLeft(1);
+  dotMatrix.setColumn(7, 0x01);
+  assertEqual(0xA5, dotMatrix.getColumn(6));
+  assertEqual(0x01, dotMatrix.getColumn(7));
+
+  dotMatrix.end();
+}
+
+DotMatrixModule<TestableLedMatrix, 8, uint16_t, 1, TestableClockInterface>
+    wideDotMatrix(ledMatrix, FRAMES_PER_SECOND);
+
+// 16 columns per row, for 8x16 signs.
+test(DotMatrixModuleTest, wideRows) {
+  wideDotMatrix.begin();
+  assertEqual(16, wideDotMatrix.kWidth);
+  wideDotMatrix.setPixel(15, 3, true);
+  assertEqual(0x8000, wideDotMatrix.getPatternAt(3));
+
+  const uint16_t bitmap[] = {0xFFFF};
+  wideDotMatrix.blit(4, 0, bitmap, 16, 1);
+  assertEqual(0xFFF0, wideDotMatrix.getPatternAt(0));
+
+  wideDotMatrix.shiftRight(1);
+  assertEqual(0xFFE0, wideDotMatrix.getPatternAt(0));
+  assertEqual(0x0000, wideDotMatrix.getPatternAt(3));
+
+  wideDotMatrix.end();
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
@@ -14,7 +14,10 @@
 
 using aunit::TestRunner;
 using ace_segment::testing::TestableWireInterface;
+using ace_segment::testing::EventType;
+using ace_segment::testing::gEventLog;
 using ace_segment::Ht16k33Module;
+using ace_segment::NoTimingProbe;
 
 //----------------------------------------------------------------------------
 
@@ -59,15 +62,146 @@ test(Ht16k33ModuleTest, isFlushRequired) {
   ht16k33Module.flush();
   assertFalse(ht16k33Module.isFlushRequired());
 
-  ht16k33Module.setPatternAt(0, 0);
+  ht16k33Module.setPatternAt(0, 0x5A);
   assertTrue(ht16k33Module.isFlushRequired());
 
   ht16k33Module.flush();
   assertFalse(ht16k33Module.isFlushRequired());
 
+  // Writing an unchanged pattern does not require a flush.
+  ht16k33Module.setPatternAt(0, 0x5A);
+  assertFalse(ht16k33Module.isFlushRequired());
+
+  ht16k33Module.end();
+}
+
+Ht16k33Module<TestableWireInterface, NUM_DIGITS, true> ht16k33ModuleShadow(
+    wireInterface, HT16K33_I2C_ADDRESS);
+
+test(Ht16k33ModuleTest, flush_shadow) {
+  ht16k33ModuleShadow.begin();
+
+  // The first flush() sends all 5 COM lines and the brightness.
+  gEventLog.clear();
+  ht16k33ModuleShadow.flush();
+  assertEqual(16, gEventLog.getNumRecords());
+
+  // Change digit 2 and back again. Nothing is sent.
+  ht16k33ModuleShadow.setPatternAt(2, 0x3F);
+  ht16k33ModuleShadow.setPatternAt(2, 0x00);
+  gEventLog.clear();
+  ht16k33ModuleShadow.flush();
+  assertEqual(0, gEventLog.getNumRecords());
+
+  // Change digit 2, which is on COM3 at address 6. No brightness follows, so
+  // the transmission ends with a STOP.
+  ht16k33ModuleShadow.setPatternAt(2, 0x3F);
+  gEventLog.clear();
+  ht16k33ModuleShadow.flush();
+  assertTrue(gEventLog.assertEvents(
+    5,
+    (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+    (int) EventType::kWireWrite, 6,
+    (int) EventType::kWireWrite, 0x3F,
+    (int) EventType::kWireWrite, 0x00,
+    (int) EventType::kWireEndTransmission
+  ));
+
+  ht16k33ModuleShadow.end();
+}
+
+// The first flushDirty() sends everything, so that later calls can skip the
+// COM lines which the chip already holds.
+test(Ht16k33ModuleTest, flushDirty_shadow) {
+  ht16k33ModuleShadow.begin();
+  gEventLog.clear();
+  ht16k33ModuleShadow.flushDirty();
+  assertEqual(16, gEventLog.getNumRecords());
+
+  // Change digit 2 and back again. Nothing is sent.
+  ht16k33ModuleShadow.setPatternAt(2, 0x3F);
+  ht16k33ModuleShadow.setPatternAt(2, 0x00);
+  gEventLog.clear();
+  ht16k33ModuleShadow.flushDirty();
+  assertEqual(0, gEventLog.getNumRecords());
+  assertFalse(ht16k33ModuleShadow.isFlushRequired());
+
+  // Change digit 3, which is on COM4 at address 8.
+  ht16k33ModuleShadow.setPatternAt(3, 0x33);
+  gEventLog.clear();
+  ht16k33ModuleShadow.flushDirty();
+  assertTrue(gEventLog.assertEvents(
+    5,
+    (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+    (int) EventType::kWireWrite, 8,
+    (int) EventType::kWireWrite, 0x33,
+    (int) EventType::kWireWrite, 0x00,
+    (int) EventType::kWireEndTransmission
+  ));
+
+  ht16k33ModuleShadow.end();
+}
+
+test(Ht16k33ModuleTest, flushDirty) {
+  ht16k33Module.begin();
+  ht16k33Module.flush();
+
+  // Digit 1 maps to COM1 and COM2 (colon), and digit 3 maps to COM4, so there
+  // are 2 runs. The first ends with a repeated START, the second with a STOP.
+  ht16k33Module.setPatternAt(1, 0x11);
+  ht16k33Module.setPatternAt(3, 0x33);
+  gEventLog.clear();
+  ht16k33Module.flushDirty();
+  assertTrue(gEventLog.assertEvents(
+    12,
+    (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+    (int) EventType::kWireWrite, 2,
+    (int) EventType::kWireWrite, 0x11,
+    (int) EventType::kWireWrite, 0x00,
+    (int) EventType::kWireWrite, 0x00,
+    (int) EventType::kWireWrite, 0x00,
+    (int) EventType::kWireEndTransmission,
+
+    (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+    (int) EventType::kWireWrite, 8,
+    (int) EventType::kWireWrite, 0x33,
+    (int) EventType::kWireWrite, 0x00,
+    (int) EventType::kWireEndTransmission
+  ));
+  assertFalse(ht16k33Module.isFlushRequired());
+
   ht16k33Module.end();
 }
 
+Ht16k33Module<TestableWireInterface, NUM_DIGITS, true, NoTimingProbe, uint16_t>
+    ht16k33ModuleWide(wireInterface, HT16K33_I2C_ADDRESS);
+
+test(Ht16k33ModuleTest, flush_widePattern) {
+  ht16k33ModuleWide.begin();
+  ht16k33ModuleWide.flush();
+
+  // Each digit is on its own COM line, with the upper 8 bits on ROW8-ROW15.
+  // Only the high byte of digit 2 differs from the shadow, but both bytes of
+  // its COM line are sent.
+  ht16k33ModuleWide.setPatternAt(2, 0x1200);
+  gEventLog.clear();
+  ht16k33ModuleWide.flush();
+  assertTrue(gEventLog.assertEvents(
+    5,
+    (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+    (int) EventType::kWireWrite, 4,
+    (int) EventType::kWireWrite, 0x00,
+    (int) EventType::kWireWrite, 0x12,
+    (int) EventType::kWireEndTransmission
+  ));
+
+  // The colon has no COM line of its own.
+  ht16k33ModuleWide.enableColon(true);
+  assertFalse(ht16k33ModuleWide.isFlushRequired());
+
+  ht16k33ModuleWide.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
@@ -0,0 +1,122 @@
+#line 2 "LedCanvasTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2022 Brian T. Park
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/TestableLedModule.h>
+
+using aunit::TestRunner;
+using ace_segment::LedCanvas;
+using ace_segment::testing::TestableLedModule;
+
+//----------------------------------------------------------------------------
+
+const uint8_t NUM_DIGITS = 4;
+const uint8_t WIDTH = 10;
+const uint8_t PATTERNS[WIDTH] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+TestableLedModule<NUM_DIGITS> ledModule;
+LedCanvas<WIDTH> canvas(ledModule);
+
+test(LedCanvasTest, begin) {
+  ledModule.begin();
+  ledModule.fillPatterns(0xFF);
+  canvas.begin();
+  assertEqual(0, canvas.getOffset());
+  for (uint8_t i = 0; i < NUM_DIGITS; ++i) {
+    assertEqual(0, ledModule.getPatternAt(i));
+  }
+}
+
+test(LedCanvasTest, setPatterns) {
+  ledModule.begin();
+  canvas.begin();
+  canvas.setPatterns(0, PATTERNS, WIDTH);
+  for (uint8_t i = 0; i < NUM_DIGITS; ++i) {
+    assertEqual(PATTERNS[i], ledModule.getPatternAt(i));
+  }
+  assertEqual(10, canvas.getPatternAt(9));
+}
+
+test(LedCanvasTest, scroll_marksOnlyChangedDigitsDirty) {
+  ledModule.begin();
+  canvas.begin();
+  const uint8_t patterns[WIDTH] = {1, 1, 1, 2, 2, 2, 2, 2, 2, 2};
+  canvas.setPatterns(0, patterns, WIDTH);
+  ledModule.clearDigitsDirty();
+
+  // {1,1,1,2} -> {1,1,2,2}
+  canvas.scroll();
+  assertEqual(1, canvas.getOffset());
+  assertFalse(ledModule.isDigitDirty(0));
+  assertFalse(ledModule.isDigitDirty(1));
+  assertTrue(ledModule.isDigitDirty(2));
+  assertFalse(ledModule.isDigitDirty(3));
+
+  // A viewport over identical patterns changes nothing.
+  canvas.setOffset(4);
+  ledModule.clearDigitsDirty();
+  canvas.scroll();
+  assertFalse(ledModule.isAnyDigitDirty());
+}
+
+test(LedCanvasTest, scroll_wrapsAround) {
+  ledModule.begin();
+  canvas.begin();
+  canvas.setPatterns(0, PATTERNS, WIDTH);
+
+  // The viewport spans the end and the beginning of the canvas.
+  canvas.setOffset(8);
+  assertEqual(9, ledModule.getPatternAt(0));
+  assertEqual(10, ledModule.getPatternAt(1));
+  assertEqual(1, ledModule.getPatternAt(2));
+  assertEqual(2, ledModule.getPatternAt(3));
+
+  canvas.scroll(3);
+  assertEqual(1, canvas.getOffset());
+  assertEqual(2, ledModule.getPatternAt(0));
+
+  // Scrolling backwards.
+  canvas.scroll(-2);
+  assertEqual(9, canvas.getOffset());
+  assertEqual(10, ledModule.getPatternAt(0));
+  assertEqual(1, ledModule.getPatternAt(1));
+}
+
+test(LedCanvasTest, setPatternAt) {
+  ledModule.begin();
+  canvas.begin();
+  canvas.setOffset(8);
+  ledModule.clearDigitsDirty();
+
+  // Position 1 is shown on digit 3.
+  canvas.setPatternAt(1, 0x11);
+  assertEqual(0x11, ledModule.getPatternAt(3));
+  assertTrue(ledModule.isDigitDirty(3));
+
+  // Position 5 is not visible.
+  ledModule.clearDigitsDirty();
+  canvas.setPatternAt(5, 0x55);
+  assertEqual(0x55, canvas.getPatternAt(5));
+  assertFalse(ledModule.isAnyDigitDirty());
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
@@ -32,6 +32,16 @@ LedMatrixDirect<TestableGpioInterface> ledMatrixDirect(
     NUM_DIGITS,
     DIGIT_PINS);
 
+// 10 digits wired as the elements, for kScanningOptionSegmentMajor
+const uint8_t WIDE_ELEMENT_PINS[10] = {4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+LedMatrixDirect<TestableGpioInterface, uint16_t> wideLedMatrixDirect(
+    kActiveHighPattern /*elementOnPattern*/,
+    kActiveHighPattern /*groupOnPattern*/,
+    10 /*numElements*/,
+    WIDE_ELEMENT_PINS,
+    NUM_DIGITS,
+    DIGIT_PINS);
+
 // Common Cathode, with transistors on Group pins
 TestableSpiInterface spiInterface;
 LedMatrixSingleHc595<TestableSpiInterface, TestableGpioInterface>
@@ -142,6 +152,25 @@ testF(LedMatrixDirectTest, drawElements) {
   ));
 }
 
+// The 16-bit element pattern reaches the element pins above 8.
+testF(LedMatrixDirectTest, draw_wide) {
+  wideLedMatrixDirect.draw(0, 0x0201);
+  assertEqual(11, gEventLog.getNumRecords());
+  assertTrue(gEventLog.assertEvents(11,
+      (int) EventType::kDigitalWrite, 4, HIGH,
+      (int) EventType::kDigitalWrite, 5, LOW,
+      (int) EventType::kDigitalWrite, 6, LOW,
+      (int) EventType::kDigitalWrite, 7, LOW,
+      (int) EventType::kDigitalWrite, 8, LOW,
+      (int) EventType::kDigitalWrite, 9, LOW,
+      (int) EventType::kDigitalWrite, 10, LOW,
+      (int) EventType::kDigitalWrite, 11, LOW,
+      (int) EventType::kDigitalWrite, 12, LOW,
+      (int) EventType::kDigitalWrite, 13, HIGH,
+      (int) EventType::kDigitalWrite, 0, HIGH
+  ));
+}
+
 // ----------------------------------------------------------------------
 // Tests for LedMatrixSingleHc595.
 // ----------------------------------------------------------------------
@@ -201,6 +230,29 @@ testF(LedMatrixSingleHc595Test, drawElements) {
   ));
 }
 
+// Common Anode 14-segment digits, on 2 daisy chained 74HC595 chips.
+LedMatrixSingleHc595<TestableSpiInterface, TestableGpioInterface, uint16_t>
+  ledMatrixSingleHc595Wide(
+    spiInterface,
+    kActiveLowPattern /*elementOnPattern*/,
+    kActiveHighPattern /*groupOnPattern*/,
+    NUM_DIGITS,
+    DIGIT_PINS);
+
+testF(LedMatrixSingleHc595Test, draw_widePattern) {
+  ledMatrixSingleHc595Wide.draw(0, 0x0000);
+  gEventLog.clear();
+
+  // Both bytes are inverted for the active low segments.
+  ledMatrixSingleHc595Wide.draw(1, 0x1255);
+  assertEqual(3, gEventLog.getNumRecords());
+  assertTrue(gEventLog.assertEvents(3,
+      (int) EventType::kDigitalWrite, 0, LOW,
+      (int) EventType::kSpiSend16, 0xEDAA,
+      (int) EventType::kDigitalWrite, 1, HIGH
+  ));
+}
+
 // ----------------------------------------------------------------------
 // Tests for LedMatrixSplitSpi.
 // ----------------------------------------------------------------------
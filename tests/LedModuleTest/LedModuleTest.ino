@@ -0,0 +1,243 @@
+#line 2 "LedModuleTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2021 Brian T. Park
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/TestableLedModule.h>
+
+using aunit::TestRunner;
+using ace_segment::LedModule;
+using ace_segment::testing::TestableLedModule;
+
+//----------------------------------------------------------------------------
+
+test(LedModuleTest, numDirtyBytes) {
+  assertEqual(1, LedModule::numDirtyBytes(1));
+  assertEqual(1, LedModule::numDirtyBytes(8));
+  assertEqual(2, LedModule::numDirtyBytes(9));
+  assertEqual(2, LedModule::numDirtyBytes(16));
+  assertEqual(3, LedModule::numDirtyBytes(17));
+}
+
+test(LedModuleTest, dirtyBits_smallModule) {
+  TestableLedModule<4> ledModule;
+  ledModule.begin();
+  assertTrue(ledModule.isAnyDigitDirty());
+
+  // Clearing each digit individually must clear the entire module.
+  for (uint8_t i = 0; i < 4; ++i) {
+    assertTrue(ledModule.isDigitDirty(i));
+    ledModule.clearDigitDirty(i);
+  }
+  assertFalse(ledModule.isAnyDigitDirty());
+
+  ledModule.setPatternAt(3, 0x11);
+  assertTrue(ledModule.isDigitDirty(3));
+  assertFalse(ledModule.isDigitDirty(2));
+  assertTrue(ledModule.isAnyDigitDirty());
+}
+
+// 8 digits still fit in the single byte of an LedModule.
+test(LedModuleTest, dirtyBits_eightDigits) {
+  TestableLedModule<8> ledModule;
+  LedModule& base = ledModule;
+  assertEqual(8, base.getNumDigits());
+
+  ledModule.begin();
+  for (uint8_t i = 0; i < 8; ++i) {
+    assertTrue(ledModule.isDigitDirty(i));
+    ledModule.clearDigitDirty(i);
+  }
+  assertFalse(ledModule.isAnyDigitDirty());
+
+  base.setPatternAt(7, 0x44);
+  assertTrue(ledModule.isDigitDirty(7));
+  assertFalse(ledModule.isDigitDirty(6));
+}
+
+test(LedModuleTest, dirtyBits_largeModule) {
+  TestableLedModule<12> ledModule;
+  ledModule.begin();
+  ledModule.clearDigitsDirty();
+  assertFalse(ledModule.isAnyDigitDirty());
+
+  // Digits beyond the first 8 have their own dirty bits.
+  ledModule.setPatternAt(11, 0x22);
+  assertTrue(ledModule.isDigitDirty(11));
+  assertFalse(ledModule.isDigitDirty(3));
+  assertFalse(ledModule.isDigitDirty(10));
+  assertTrue(ledModule.isAnyDigitDirty());
+
+  ledModule.setPatternAt(8, 0x33);
+  assertTrue(ledModule.isDigitDirty(8));
+  assertFalse(ledModule.isDigitDirty(0));
+
+  ledModule.clearDigitDirty(11);
+  assertFalse(ledModule.isDigitDirty(11));
+  assertTrue(ledModule.isAnyDigitDirty());
+  ledModule.clearDigitDirty(8);
+  assertFalse(ledModule.isAnyDigitDirty());
+
+  // setDigitsDirty() marks only the valid digits.
+  ledModule.setDigitsDirty();
+  for (uint8_t i = 0; i < 12; ++i) {
+    assertTrue(ledModule.isDigitDirty(i));
+    ledModule.clearDigitDirty(i);
+  }
+  assertFalse(ledModule.isAnyDigitDirty());
+}
+
+test(LedModuleTest, setPatternAt_unchangedIsNotDirty) {
+  TestableLedModule<4> ledModule;
+  ledModule.begin();
+  ledModule.setPatternAt(1, 0x11);
+  ledModule.clearDigitsDirty();
+
+  // Writing the same pattern does not mark the digit dirty.
+  ledModule.setPatternAt(1, 0x11);
+  assertFalse(ledModule.isDigitDirty(1));
+  assertFalse(ledModule.isAnyDigitDirty());
+
+  // Writing a different pattern does.
+  ledModule.setPatternAt(1, 0x12);
+  assertTrue(ledModule.isDigitDirty(1));
+  assertEqual(0x12, ledModule.getPatternAt(1));
+}
+
+test(LedModuleTest, setPatterns) {
+  TestableLedModule<12> ledModule;
+  ledModule.begin();
+  ledModule.fillPatterns(0);
+  ledModule.clearDigitsDirty();
+
+  // Spans the boundary between the first and second dirty bytes.
+  const uint8_t patterns[] = {0x00, 0x11, 0x22, 0x33};
+  ledModule.setPatterns(6, patterns, 4);
+  assertEqual(0x11, ledModule.getPatternAt(7));
+  assertEqual(0x22, ledModule.getPatternAt(8));
+  assertEqual(0x33, ledModule.getPatternAt(9));
+  assertFalse(ledModule.isDigitDirty(5));
+  assertFalse(ledModule.isDigitDirty(6)); // unchanged
+  assertTrue(ledModule.isDigitDirty(7));
+  assertTrue(ledModule.isDigitDirty(8));
+  assertTrue(ledModule.isDigitDirty(9));
+  assertFalse(ledModule.isDigitDirty(10));
+
+  // Rewriting the same patterns does not mark anything dirty.
+  ledModule.clearDigitsDirty();
+  ledModule.setPatterns(6, patterns, 4);
+  assertFalse(ledModule.isAnyDigitDirty());
+}
+
+test(LedModuleTest, fillPatterns) {
+  TestableLedModule<12> ledModule;
+  ledModule.begin();
+  ledModule.fillPatterns(0);
+  ledModule.setPatternAt(3, 0xFF);
+  ledModule.getPatterns()[12] = 0;
+  ledModule.clearDigitsDirty();
+
+  ledModule.fillPatterns(0xFF);
+  for (uint8_t i = 0; i < 12; ++i) {
+    assertEqual(0xFF, ledModule.getPatternAt(i));
+    assertEqual(i != 3, ledModule.isDigitDirty(i));
+  }
+  // Must not write beyond the last digit.
+  assertEqual(0, ledModule.getPatterns()[12]);
+}
+
+test(LedModuleTest, shiftPatterns) {
+  TestableLedModule<10> ledModule;
+  ledModule.begin();
+  const uint8_t patterns[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  ledModule.setPatterns(0, patterns, 10);
+  ledModule.clearDigitsDirty();
+
+  // Shift towards position 0, blanking the end.
+  ledModule.shiftPatterns(3);
+  const uint8_t expectedLeft[] = {4, 5, 6, 7, 8, 9, 10, 0, 0, 0};
+  for (uint8_t i = 0; i < 10; ++i) {
+    assertEqual(expectedLeft[i], ledModule.getPatternAt(i));
+    assertTrue(ledModule.isDigitDirty(i));
+  }
+
+  // Shift towards the last position, blanking the beginning.
+  ledModule.clearDigitsDirty();
+  ledModule.shiftPatterns(-2);
+  const uint8_t expectedRight[] = {0, 0, 4, 5, 6, 7, 8, 9, 10, 0};
+  for (uint8_t i = 0; i < 10; ++i) {
+    assertEqual(expectedRight[i], ledModule.getPatternAt(i));
+  }
+  assertFalse(ledModule.isDigitDirty(9)); // 0 -> 0
+  assertTrue(ledModule.isDigitDirty(8));
+  assertTrue(ledModule.isDigitDirty(0));
+
+  // Shifting by 0 changes nothing.
+  ledModule.clearDigitsDirty();
+  ledModule.shiftPatterns(0);
+  assertFalse(ledModule.isAnyDigitDirty());
+
+  // Shifting by more than the number of digits blanks the display.
+  ledModule.shiftPatterns(-10);
+  for (uint8_t i = 0; i < 10; ++i) {
+    assertEqual(0, ledModule.getPatternAt(i));
+  }
+  assertTrue(ledModule.isAnyDigitDirty());
+}
+
+test(LedModuleTest, nextDirtyRun) {
+  TestableLedModule<10> ledModule;
+  ledModule.begin();
+  ledModule.clearDigitsDirty();
+  ledModule.setDigitDirty(1);
+  ledModule.setDigitDirty(2);
+  ledModule.setDigitDirty(7);
+  ledModule.setDigitDirty(8);
+  ledModule.setDigitDirty(9);
+
+  // Without remapping, runs are [1, 3) and [7, 10).
+  uint8_t beginPos = 0;
+  uint8_t endPos = ledModule.nextDirtyRun(beginPos, 10, nullptr);
+  assertEqual(1, beginPos);
+  assertEqual(3, endPos);
+  beginPos = endPos;
+  endPos = ledModule.nextDirtyRun(beginPos, 10, nullptr);
+  assertEqual(7, beginPos);
+  assertEqual(10, endPos);
+  beginPos = endPos;
+  endPos = ledModule.nextDirtyRun(beginPos, 10, nullptr);
+  assertEqual(10, beginPos);
+  assertEqual(10, endPos);
+
+  // Reversed chip order: chip position i shows digit (9 - i), so the runs in
+  // chip order are [0, 3) and [7, 9).
+  const uint8_t remap[] = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+  beginPos = 0;
+  endPos = ledModule.nextDirtyRun(beginPos, 10, remap);
+  assertEqual(0, beginPos);
+  assertEqual(3, endPos);
+  beginPos = endPos;
+  endPos = ledModule.nextDirtyRun(beginPos, 10, remap);
+  assertEqual(7, beginPos);
+  assertEqual(9, endPos);
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
@@ -10,9 +10,12 @@
 #include <AUnitVerbose.h>
 #include <AceSegment.h>
 #include <ace_segment/testing/TestableSpiInterface.h>
+#include <ace_segment/testing/EventLog.h>
 
 using aunit::TestRunner;
 using ace_segment::testing::TestableSpiInterface;
+using ace_segment::testing::EventType;
+using ace_segment::testing::gEventLog;
 using ace_segment::Max7219Module;
 using ace_segment::internal::convertPatternMax7219;
 
@@ -34,15 +37,49 @@ test(Max7219ModuleTest, isFlushRequired) {
   max7219Module.flush();
   assertFalse(max7219Module.isFlushRequired());
 
-  max7219Module.setPatternAt(0, 0);
+  max7219Module.setPatternAt(0, 0x5A);
   assertTrue(max7219Module.isFlushRequired());
 
   max7219Module.flush();
   assertFalse(max7219Module.isFlushRequired());
 
+  // Writing an unchanged pattern does not require a flush.
+  max7219Module.setPatternAt(0, 0x5A);
+  assertFalse(max7219Module.isFlushRequired());
+
   max7219Module.end();
 }
 
+Max7219Module<TestableSpiInterface, NUM_DIGITS, true> max7219ModuleShadow(
+    spiInterface);
+
+test(Max7219ModuleTest, flush_shadow) {
+  max7219ModuleShadow.begin();
+
+  // The first flush() sends all 8 digits and the intensity.
+  gEventLog.clear();
+  max7219ModuleShadow.flush();
+  assertEqual(9, gEventLog.getNumRecords());
+
+  // Change digit 3 and back again. Nothing is sent.
+  max7219ModuleShadow.setPatternAt(3, 0x01);
+  max7219ModuleShadow.setPatternAt(3, 0x00);
+  gEventLog.clear();
+  max7219ModuleShadow.flush();
+  assertEqual(0, gEventLog.getNumRecords());
+
+  // Change digit 3. Only register 4 (digit 3) is sent.
+  max7219ModuleShadow.setPatternAt(3, 0x01);
+  gEventLog.clear();
+  max7219ModuleShadow.flush();
+  assertTrue(gEventLog.assertEvents(
+    1,
+    (int) EventType::kSpiSend16, 0x0400 | convertPatternMax7219(0x01)
+  ));
+
+  max7219ModuleShadow.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
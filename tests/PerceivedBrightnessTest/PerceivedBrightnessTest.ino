@@ -0,0 +1,83 @@
+#line 2 "PerceivedBrightnessTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2022 Brian T. Park
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+#include <ace_segment/testing/TestableLedMatrix.h>
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+//----------------------------------------------------------------------------
+
+// The table is computed by the compiler.
+static_assert(internal::perceivedToBrightness(0, 8, 63) == 0, "");
+static_assert(internal::perceivedToBrightness(7, 8, 63) == 63, "");
+
+test(PerceivedBrightnessTest, toBrightness) {
+  using Brightness = PerceivedBrightness<8, 63>;
+  const uint8_t expected[] = {0, 1, 4, 8, 16, 27, 42, 63};
+  for (uint8_t i = 0; i < 8; ++i) {
+    assertEqual(expected[i], Brightness::toBrightness(i));
+  }
+
+  // Clamped to the highest level.
+  assertEqual(63, Brightness::toBrightness(8));
+  assertEqual(63, Brightness::toBrightness(255));
+}
+
+// A non-zero level is never turned off, even if the raw scale is too coarse.
+test(PerceivedBrightnessTest, toBrightness_coarse) {
+  using Brightness = PerceivedBrightness<16, 15>;
+  assertEqual(0, Brightness::toBrightness(0));
+  assertEqual(1, Brightness::toBrightness(1));
+  for (uint8_t i = 1; i < 16; ++i) {
+    assertLessOrEqual(Brightness::toBrightness(i - 1),
+        Brightness::toBrightness(i));
+  }
+  assertEqual(15, Brightness::toBrightness(15));
+}
+
+TestableLedMatrix ledMatrix;
+
+using BitAngleModule = ScanningModule<
+    TestableLedMatrix,
+    4 /*digits*/,
+    6 /*bits*/,
+    TestableClockInterface,
+    kScanningOptionBitAngle
+>;
+BitAngleModule bitAngleModule(ledMatrix, 60);
+
+// The raw scale of a ScanningModule can be taken from kMaxBrightness.
+test(PerceivedBrightnessTest, scanningModule) {
+  using Brightness = PerceivedBrightness<8, BitAngleModule::kMaxBrightness>;
+  bitAngleModule.begin();
+  bitAngleModule.setBrightness(Brightness::toBrightness(7));
+  assertEqual(63, bitAngleModule.getBrightnessAt(0));
+  bitAngleModule.setBrightnessAt(1, Brightness::toBrightness(3));
+  assertEqual(8, bitAngleModule.getBrightnessAt(1));
+  bitAngleModule.end();
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
@@ -0,0 +1,131 @@
+#line 2 "ScanningGroupTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2021 Brian T. Park
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/EventLog.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+#include <ace_segment/testing/TestableLedMatrix.h>
+#include <ace_segment/testing/TestableTimerInterface.h>
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+//----------------------------------------------------------------------------
+
+const uint16_t FRAMES_PER_SECOND = 60;
+
+TestableLedMatrix ledMatrixA;
+TestableLedMatrix ledMatrixB;
+
+ScanningModule<TestableLedMatrix, 4, 1, TestableClockInterface>
+    moduleA(ledMatrixA, FRAMES_PER_SECOND);
+ScanningModule<TestableLedMatrix, 2, 1, TestableClockInterface>
+    moduleB(ledMatrixB, FRAMES_PER_SECOND);
+
+ScanningGroup<2, TestableClockInterface, TestableTimerInterface> group;
+
+void setupGroup() {
+  moduleA.begin();
+  moduleB.begin();
+  group.setModuleAt(0, moduleA);
+  group.setModuleAt(1, moduleB);
+  group.begin();
+  ledMatrixA.mEventLog.clear();
+  ledMatrixB.mEventLog.clear();
+}
+
+// Each tick renders a single field of a single module, alternating between
+// the modules.
+test(ScanningGroupTest, renderFieldNow) {
+  setupGroup();
+  moduleA.setPatternAt(1, 0x11);
+  moduleB.setPatternAt(1, 0x22);
+  assertEqual(0, group.mCurrentModule);
+
+  group.renderFieldNow();
+  assertEqual(1, ledMatrixA.mEventLog.getNumRecords());
+  assertEqual(0, ledMatrixB.mEventLog.getNumRecords());
+  assertEqual(1, group.mCurrentModule);
+
+  group.renderFieldNow();
+  assertEqual(1, ledMatrixA.mEventLog.getNumRecords());
+  assertEqual(1, ledMatrixB.mEventLog.getNumRecords());
+  assertEqual(0, group.mCurrentModule);
+
+  group.renderFieldNow();
+  group.renderFieldNow();
+  assertTrue(ledMatrixA.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x11));
+  assertTrue(ledMatrixB.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x22));
+}
+
+// The group ticks at the rate of the faster module times the number of
+// modules.
+test(ScanningGroupTest, getMicrosPerField) {
+  setupGroup();
+  assertEqual(1000000 / (60 * 4), moduleA.getMicrosPerField());
+  assertEqual(1000000 / (60 * 4) / 2, group.getMicrosPerField());
+}
+
+test(ScanningGroupTest, renderFieldWhenReady) {
+  TestableClockInterface::setMicros(1000);
+  setupGroup();
+  const uint16_t period = group.getMicrosPerField();
+
+  assertTrue(group.renderFieldWhenReady());
+  assertFalse(group.renderFieldWhenReady());
+  TestableClockInterface::setMicros(1000 + period);
+  assertTrue(group.renderFieldWhenReady());
+  assertEqual(1, ledMatrixA.mEventLog.getNumRecords());
+  assertEqual(1, ledMatrixB.mEventLog.getNumRecords());
+
+  // A poll which misses more than one field restarts the schedule.
+  TestableClockInterface::setMicros(1000 + 4 * period);
+  assertTrue(group.renderFieldWhenReady());
+  assertFalse(group.renderFieldWhenReady());
+  TestableClockInterface::setMicros(1000 + 5 * period);
+  assertTrue(group.renderFieldWhenReady());
+}
+
+// A single timer drives both modules.
+test(ScanningGroupTest, startTimer) {
+  TestableClockInterface::setMicros(0);
+  TestableTimerInterface::setLatencyMicros(0);
+  setupGroup();
+  const uint16_t period = group.getMicrosPerField();
+  group.startTimer();
+
+  TestableTimerInterface::advanceMicros(4 * period);
+  assertEqual(4, TestableTimerInterface::sNumInterrupts);
+  assertEqual(2, ledMatrixA.mEventLog.getNumRecords());
+  assertEqual(2, ledMatrixB.mEventLog.getNumRecords());
+
+  group.stopTimer();
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
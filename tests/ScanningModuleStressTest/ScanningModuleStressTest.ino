@@ -0,0 +1,200 @@
+#line 2 "ScanningModuleStressTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2022 Brian T. Park
+ */
+
+/*
+ * Stress test of the handoff between the application and the renderer of a
+ * ScanningModule configured with kScanningOptionDoubleBuffer. The renderer,
+ * which would normally be a timer interrupt, runs in a separate thread and
+ * calls renderFieldNow() continuously, while the main thread keeps changing
+ * the patterns and brightness levels. Every frame must show the patterns and
+ * brightness levels of a single commit() on all digits.
+ *
+ * Runs only under EpoxyDuino, because it requires POSIX threads.
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+
+#if defined(EPOXY_DUINO)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+#if defined(EPOXY_DUINO)
+
+const uint8_t NUM_DIGITS = 4;
+const uint8_t NUM_SUBFIELDS = 4;
+const uint16_t FRAMES_PER_SECOND = 60;
+const uint16_t NUM_COMMITS = 20000;
+
+/** LedMatrix which remembers what is currently displayed. */
+class RecordingLedMatrix {
+  public:
+    void draw(uint8_t group, uint8_t pattern) const {
+      mGroup = group;
+      mPattern = pattern;
+    }
+
+    void clear() const {
+      mPattern = 0;
+    }
+
+  public:
+    mutable uint8_t mGroup;
+    mutable uint8_t mPattern;
+};
+
+RecordingLedMatrix ledMatrix;
+
+ScanningModule<
+    RecordingLedMatrix,
+    NUM_DIGITS,
+    NUM_SUBFIELDS,
+    TestableClockInterface,
+    kScanningOptionDoubleBuffer
+> scanningModule(ledMatrix, FRAMES_PER_SECOND);
+
+/** Pattern written by the given commit. Never 0. */
+uint8_t patternOf(uint16_t commit) {
+  return 1 + commit % 200;
+}
+
+/** Brightness written along with the given pattern. Never 0. */
+uint8_t brightnessOf(uint8_t pattern) {
+  return 1 + (pattern - 1) % NUM_SUBFIELDS;
+}
+
+// Written only by the renderer thread, read by the main thread after join.
+uint32_t numFrames;
+uint32_t numTornFrames;
+uint32_t numChanges;
+
+// Written only by the main thread.
+volatile bool isStopRequested;
+
+/**
+ * Render complete frames until stopped, and check that each frame shows the
+ * same pattern on every digit, at the brightness which was committed with it.
+ */
+void* renderLoop(void* /*arg*/) {
+  uint8_t prevFramePattern = 0;
+  while (! isStopRequested) {
+    uint8_t framePattern = 0;
+    bool isTorn = false;
+
+    for (uint8_t digit = 0; digit < NUM_DIGITS; digit++) {
+      uint8_t digitPattern = 0;
+      uint8_t numLit = 0;
+      for (uint8_t subField = 0; subField < NUM_SUBFIELDS; subField++) {
+        scanningModule.renderFieldNow();
+
+        // A timer interrupt returns the processor to loop() between fields.
+        // Yield, so that the main thread also runs on a single core machine.
+        sched_yield();
+
+        if (ledMatrix.mGroup != digit) isTorn = true;
+        if (ledMatrix.mPattern == 0) continue;
+        if (digitPattern != 0 && ledMatrix.mPattern != digitPattern) {
+          isTorn = true;
+        }
+        digitPattern = ledMatrix.mPattern;
+        numLit++;
+      }
+
+      if (digit == 0) framePattern = digitPattern;
+      if (digitPattern == 0
+          || digitPattern != framePattern
+          || numLit != brightnessOf(digitPattern)) {
+        isTorn = true;
+      }
+    }
+
+    numFrames++;
+    if (isTorn) numTornFrames++;
+    if (framePattern != prevFramePattern) numChanges++;
+    prevFramePattern = framePattern;
+  }
+  return nullptr;
+}
+
+/** Write the patterns and brightness of the given commit, then commit(). */
+void writeCommit(uint16_t commit) {
+  uint8_t pattern = patternOf(commit);
+  uint8_t brightness = brightnessOf(pattern);
+
+  // Exercise both the global and the per-digit setters.
+  if (commit & 0x1) {
+    scanningModule.fillPatterns(pattern);
+    scanningModule.setBrightness(brightness);
+  } else {
+    for (uint8_t i = 0; i < NUM_DIGITS; i++) {
+      scanningModule.setPatternAt(i, pattern);
+      scanningModule.setBrightnessAt(i, brightness);
+    }
+  }
+  scanningModule.commit();
+}
+
+void waitForCommit() {
+  while (scanningModule.isCommitPending()) {
+    sched_yield();
+  }
+}
+
+test(ScanningModuleStressTest, noTearing) {
+  scanningModule.begin();
+  numFrames = 0;
+  numTornFrames = 0;
+  numChanges = 0;
+  isStopRequested = false;
+
+  // The first frame must already be valid.
+  writeCommit(0);
+
+  pthread_t renderer;
+  assertEqual(0, pthread_create(&renderer, nullptr, renderLoop, nullptr));
+
+  for (uint16_t commit = 1; commit < NUM_COMMITS; commit++) {
+    waitForCommit();
+    writeCommit(commit);
+  }
+  waitForCommit();
+
+  isStopRequested = true;
+  assertEqual(0, pthread_join(renderer, nullptr));
+
+  assertEqual((uint32_t) 0, numTornFrames);
+
+  // Every commit was displayed for at least one frame, in order.
+  assertEqual((uint32_t) NUM_COMMITS, numChanges);
+  assertMoreOrEqual(numFrames, (uint32_t) NUM_COMMITS);
+
+  scanningModule.end();
+}
+
+#endif
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
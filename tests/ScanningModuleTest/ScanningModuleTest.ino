@@ -7,6 +7,7 @@
 #include <ace_segment/testing/EventLog.h>
 #include <ace_segment/testing/TestableClockInterface.h>
 #include <ace_segment/testing/TestableLedMatrix.h>
+#include <ace_segment/testing/TestableTimerInterface.h>
 
 using aunit::TestRunner;
 using aunit::TestOnce;
@@ -82,6 +83,110 @@ test(ScanningModuleTest, renderFieldNow) {
   scanningModule.end();
 }
 
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    kScanningOptionDoubleBuffer
+> doubleBufferModule(ledMatrix, FRAMES_PER_SECOND);
+
+// With kScanningOptionDoubleBuffer, the patterns become visible only after
+// commit(), and only at the start of the next frame.
+test(ScanningModuleTest, commit) {
+  doubleBufferModule.begin();
+  doubleBufferModule.setPatternAt(0, 0x10);
+  doubleBufferModule.setPatternAt(1, 0x11);
+  doubleBufferModule.setPatternAt(2, 0x12);
+  doubleBufferModule.setPatternAt(3, 0x13);
+  assertFalse(doubleBufferModule.isCommitPending());
+
+  // Not committed, so field 0 is still blank.
+  ledMatrix.mEventLog.clear();
+  doubleBufferModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x00));
+
+  // Committed in the middle of a frame, so the rest of the frame is unchanged.
+  doubleBufferModule.commit();
+  assertTrue(doubleBufferModule.isCommitPending());
+  ledMatrix.mEventLog.clear();
+  doubleBufferModule.renderFieldNow();
+  doubleBufferModule.renderFieldNow();
+  doubleBufferModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      3,
+      (int) EventType::kLedMatrixDraw, 1, 0x00,
+      (int) EventType::kLedMatrixDraw, 2, 0x00,
+      (int) EventType::kLedMatrixDraw, 3, 0x00));
+  assertTrue(doubleBufferModule.isCommitPending());
+
+  // The next frame picks up the commit.
+  ledMatrix.mEventLog.clear();
+  doubleBufferModule.renderFieldNow();
+  doubleBufferModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x10,
+      (int) EventType::kLedMatrixDraw, 1, 0x11));
+  assertFalse(doubleBufferModule.isCommitPending());
+
+  doubleBufferModule.end();
+}
+
+// commit() copies the patterns, so writing them while the commit is pending
+// does not change the next frame. A second commit() is refused until the
+// renderer has picked up the first one.
+test(ScanningModuleTest, commit_whilePending) {
+  doubleBufferModule.begin();
+  doubleBufferModule.setPatternAt(0, 0x10);
+  assertTrue(doubleBufferModule.commit());
+  doubleBufferModule.setPatternAt(0, 0x20);
+  assertFalse(doubleBufferModule.commit());
+  assertTrue(doubleBufferModule.isCommitPending());
+
+  ledMatrix.mEventLog.clear();
+  doubleBufferModule.renderFieldNow();
+  assertFalse(doubleBufferModule.isCommitPending());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x10));
+
+  // The later write is shown after the next commit().
+  assertTrue(doubleBufferModule.commit());
+  for (uint8_t i = 0; i < NUM_DIGITS - 1; ++i) {
+    doubleBufferModule.renderFieldNow();
+  }
+  ledMatrix.mEventLog.clear();
+  doubleBufferModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x20));
+
+  doubleBufferModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*subfields*/,
+    TestableClockInterface,
+    kScanningOptionDoubleBuffer
+> modulatedDoubleBufferModule(ledMatrix, FRAMES_PER_SECOND);
+
+// begin() seeds the front buffer from the back buffer, so the fields rendered
+// before the first commit() use the initial brightness instead of 0.
+test(ScanningModuleTest, begin_seedsFrontBuffer) {
+  modulatedDoubleBufferModule.begin();
+  assertFalse(modulatedDoubleBufferModule.isCommitPending());
+  for (uint8_t i = 0; i < 16; ++i) {
+    modulatedDoubleBufferModule.renderFieldNow();
+  }
+  for (uint8_t pos = 0; pos < NUM_DIGITS; ++pos) {
+    assertEqual(2, modulatedDoubleBufferModule.getBrightnessAt(pos));
+    assertEqual(2, modulatedDoubleBufferModule.getRenderedBrightnessAt(pos));
+  }
+  modulatedDoubleBufferModule.end();
+}
+
 // A subclass of ScanningModule must render the digits and segments
 // continuously. So renderFieldNow() will never reset the digit dirty bits.
 test(ScanningModuleTest, isAnyDigitDirty) {
@@ -96,19 +201,832 @@ test(ScanningModuleTest, isAnyDigitDirty) {
 
 
 // A subclass of ScanningModule keeps track of brightness on a per-digit basis.
-// The global brightness is transferred into the per-digit brightness array just
-// upon rendering. The global isBrightnessDirty() is used to keep track of
-// whether or not the global-to-per-digit must be done. So renderFieldNow() will
-// clear the isBrightnessDirty() bit.
+// The global brightness is transferred into the per-digit brightness array by
+// setBrightness() itself, so that renderFieldNow() (normally called from an
+// ISR) never writes the brightness. So the global isBrightnessDirty() bit is
+// always clear.
 test(ScanningModuleTest, isBrightnessDirty) {
   scanningModule.begin();
-  assertTrue(scanningModule.isBrightnessDirty());
+  assertFalse(scanningModule.isBrightnessDirty());
+
+  scanningModule.setBrightness(1);
+  assertFalse(scanningModule.isBrightnessDirty());
 
   scanningModule.renderFieldNow();
   assertFalse(scanningModule.isBrightnessDirty());
 
   scanningModule.end();
 }
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*subfields*/,
+    TestableClockInterface
+> modulatedModule(ledMatrix, FRAMES_PER_SECOND);
+
+// A setBrightnessAt() following a setBrightness() must not be overwritten by
+// the next renderFieldNow().
+test(ScanningModuleTest, setBrightness_thenSetBrightnessAt) {
+  modulatedModule.begin();
+  assertEqual(2, modulatedModule.getBrightnessAt(0));
+
+  modulatedModule.setBrightness(3);
+  modulatedModule.setBrightnessAt(1, 1);
+  modulatedModule.renderFieldNow();
+  assertEqual(3, modulatedModule.getBrightnessAt(0));
+  assertEqual(1, modulatedModule.getBrightnessAt(1));
+  assertEqual(3, modulatedModule.getBrightnessAt(2));
+
+  // Clamped to the number of subfields.
+  modulatedModule.setBrightness(9);
+  assertEqual(4, modulatedModule.getBrightnessAt(3));
+
+  modulatedModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*subfields*/,
+    TestableClockInterface,
+    kScanningOptionSegmentBrightness
+> segmentBrightnessModule(ledMatrix, FRAMES_PER_SECOND);
+
+// A segment shows the lower of its own brightness and the brightness of its
+// digit, still with at most one draw() per field.
+test(ScanningModuleTest, setSegmentBrightnessAt) {
+  segmentBrightnessModule.begin();
+  assertEqual(4, segmentBrightnessModule.getSegmentBrightnessAt(0, 7));
+
+  segmentBrightnessModule.setPatternAt(0, 0x81);
+  segmentBrightnessModule.setBrightnessAt(0, 4);
+  segmentBrightnessModule.setPatternAt(1, 0x83);
+  segmentBrightnessModule.setBrightnessAt(1, 2);
+  segmentBrightnessModule.setSegmentBrightness(7, 1); // decimal point
+  segmentBrightnessModule.setSegmentBrightnessAt(1, 1, 3);
+  assertEqual(1, segmentBrightnessModule.getSegmentBrightnessAt(0, 7));
+  assertEqual(3, segmentBrightnessModule.getSegmentBrightnessAt(1, 1));
+  assertEqual(4, segmentBrightnessModule.getSegmentBrightnessAt(1, 0));
+
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 8; ++i) {
+    segmentBrightnessModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      5,
+      (int) EventType::kLedMatrixDraw, 0, 0x81,
+      (int) EventType::kLedMatrixDraw, 0, 0x01,
+      (int) EventType::kLedMatrixDraw, 1, 0x83,
+      (int) EventType::kLedMatrixDraw, 1, 0x03,
+      (int) EventType::kLedMatrixDraw, 1, 0x00));
+
+  segmentBrightnessModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*subfields*/,
+    TestableClockInterface,
+    kScanningOptionDither
+> ditherModule(ledMatrix, FRAMES_PER_SECOND);
+
+// Render one frame of ditherModule, and return the number of subfields during
+// which digit 0 was on, between 1 and 4. The first field always draws digit 0,
+// and a second draw() turns it off.
+static uint8_t renderDitheredFrame() {
+  uint8_t numOnFields = 0;
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 4; ++i) {
+    ditherModule.renderFieldNow();
+    if (ledMatrix.mEventLog.getNumRecords() == 1) numOnFields++;
+  }
+  for (uint8_t i = 4; i < 16; ++i) {
+    ditherModule.renderFieldNow();
+  }
+  return numOnFields;
+}
+
+// With dithering, a fractional brightness alternates between the 2 nearest
+// levels across frames, spread evenly over 8 frames.
+test(ScanningModuleTest, renderFieldNow_dither) {
+  ditherModule.begin();
+  assertEqual(32, ditherModule.kMaxBrightness);
+  assertEqual(1000000 / (60 * 4 * 4), ditherModule.getMicrosPerField());
+  ditherModule.setPatternAt(0, 0x11);
+
+  // 2.5 subfields alternate between 2 and 3.
+  ditherModule.setBrightnessAt(0, 2 * 8 + 4);
+  for (uint8_t i = 0; i < 8; ++i) {
+    assertEqual((i % 2 == 0) ? 2 : 3, renderDitheredFrame());
+  }
+
+  // 1.125 subfields are at 2 for exactly 1 frame out of 8.
+  ditherModule.setBrightnessAt(0, 1 * 8 + 1);
+  uint8_t numOnFields = 0;
+  for (uint8_t i = 0; i < 8; ++i) {
+    numOnFields += renderDitheredFrame();
+  }
+  assertEqual(9, numOnFields);
+
+  ditherModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*subfields*/,
+    TestableClockInterface,
+    kScanningOptionFade
+> fadeModule(ledMatrix, FRAMES_PER_SECOND);
+
+// Render one frame of fadeModule.
+static void renderFadeFrame() {
+  for (uint8_t i = 0; i < 16; ++i) {
+    fadeModule.renderFieldNow();
+  }
+}
+
+// The renderer moves the brightness towards its target by one step per frame,
+// or back and forth between 0 and the target for a pulse.
+test(ScanningModuleTest, renderFieldNow_fade) {
+  fadeModule.begin();
+  fadeModule.setPatternAt(0, 0x11);
+  fadeModule.setPatternAt(1, 0x22);
+
+  // Without a step, the brightness changes at the next frame.
+  assertEqual(0, fadeModule.getRenderedBrightnessAt(0));
+  renderFadeFrame();
+  assertEqual(2, fadeModule.getRenderedBrightnessAt(0));
+  assertEqual(2, fadeModule.getRenderedBrightnessAt(1));
+
+  // Half a level per frame to the target of 4. Digit 1 pulses by one level
+  // per frame, starting downwards because it is already at its target.
+  fadeModule.setFadeStepAt(0, 8);
+  fadeModule.setBrightnessAt(0, 4);
+  fadeModule.setFadeStepAt(1, 16);
+  fadeModule.setPulseAt(1, true);
+  const uint8_t expected0[] = {2, 3, 3, 4, 4, 4};
+  const uint8_t expected1[] = {2, 1, 0, 1, 2, 1};
+  for (uint8_t i = 0; i < 6; ++i) {
+    renderFadeFrame();
+    assertEqual(expected0[i], fadeModule.getRenderedBrightnessAt(0));
+    assertEqual(expected1[i], fadeModule.getRenderedBrightnessAt(1));
+  }
+  assertEqual(4, fadeModule.getBrightnessAt(0));
+  assertEqual(2, fadeModule.getBrightnessAt(1));
+
+  // The faded brightness is rendered: digit 1 is off at level 0.
+  fadeModule.setPulseAt(1, false);
+  fadeModule.setBrightnessAt(1, 0);
+  fadeModule.setFadeStepAt(1, 0);
+  renderFadeFrame();
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 8; ++i) {
+    fadeModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x00));
+
+  fadeModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    3 /*bits*/,
+    TestableClockInterface,
+    kScanningOptionBitAngle
+> bitAngleModule(ledMatrix, FRAMES_PER_SECOND);
+
+// With bit angle modulation, subfield n of a digit is on if bit n of its
+// brightness is set, and lasts for (1 << n) units of getMicrosPerField().
+test(ScanningModuleTest, renderFieldNow_bitAngle) {
+  bitAngleModule.begin();
+  // 4 digits * 7 units per digit at 60 fps
+  assertEqual(1000000 / (60 * 4 * 7), bitAngleModule.getMicrosPerField());
+  const uint16_t unit = bitAngleModule.getMicrosPerField();
+
+  // Clamped to (1 << 3) - 1.
+  bitAngleModule.setBrightness(9);
+  assertEqual(7, bitAngleModule.getBrightnessAt(0));
+
+  bitAngleModule.setBrightnessAt(0, 5); // 0b101
+  bitAngleModule.setPatternAt(0, 0x11);
+  ledMatrix.mEventLog.clear();
+
+  bitAngleModule.renderFieldNow();
+  assertEqual(unit, bitAngleModule.getMicrosUntilNextField());
+  bitAngleModule.renderFieldNow();
+  assertEqual(2 * unit, bitAngleModule.getMicrosUntilNextField());
+  bitAngleModule.renderFieldNow();
+  assertEqual(4 * unit, bitAngleModule.getMicrosUntilNextField());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      3,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 0, 0x11));
+
+  // Digit 1 starts after 3 subfields, instead of 7 with PWM.
+  ledMatrix.mEventLog.clear();
+  bitAngleModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 1, 0x00));
+  assertEqual(12, bitAngleModule.getFieldsPerFrame());
+
+  bitAngleModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    2 /*digits*/,
+    4 /*subfields*/,
+    TestableClockInterface,
+    kScanningOptionInterleave
+> interleaveModule(ledMatrix, FRAMES_PER_SECOND);
+
+// Each digit is drawn once per subfield, and the subfields are visited in
+// bit-reversed order 0, 2, 1, 3, so that a digit at brightness 2 is on in the
+// first and third quarters of the frame.
+test(ScanningModuleTest, renderFieldNow_interleave) {
+  interleaveModule.begin();
+  assertEqual(8, interleaveModule.getFieldsPerFrame());
+  interleaveModule.setPatternAt(0, 0x11);
+  interleaveModule.setPatternAt(1, 0x22);
+  interleaveModule.setBrightnessAt(0, 2);
+  interleaveModule.setBrightnessAt(1, 4);
+
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 8; ++i) {
+    interleaveModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      8,
+      (int) EventType::kLedMatrixDraw, 0, 0x11, // subfield 0
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 0, 0x00, // subfield 2
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 0, 0x11, // subfield 1
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 0, 0x00, // subfield 3
+      (int) EventType::kLedMatrixDraw, 1, 0x22));
+
+  // The next frame starts again at subfield 0 of digit 0.
+  ledMatrix.mEventLog.clear();
+  interleaveModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x11));
+
+  interleaveModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    2 /*digits*/,
+    3 /*bits*/,
+    TestableClockInterface,
+    kScanningOptionInterleave | kScanningOptionBitAngle
+> interleaveBitAngleModule(ledMatrix, FRAMES_PER_SECOND);
+
+// With bit angle modulation, every digit shows bit n for (1 << n) units before
+// the next bit.
+test(ScanningModuleTest, renderFieldNow_interleaveBitAngle) {
+  interleaveBitAngleModule.begin();
+  const uint16_t unit = interleaveBitAngleModule.getMicrosPerField();
+  interleaveBitAngleModule.setPatternAt(0, 0x11);
+  interleaveBitAngleModule.setPatternAt(1, 0x22);
+  interleaveBitAngleModule.setBrightnessAt(0, 5); // 0b101
+  interleaveBitAngleModule.setBrightnessAt(1, 2); // 0b010
+
+  ledMatrix.mEventLog.clear();
+  const uint16_t expectedMicros[] = {1, 1, 2, 2, 4, 4};
+  for (uint8_t i = 0; i < 6; ++i) {
+    interleaveBitAngleModule.renderFieldNow();
+    assertEqual(expectedMicros[i] * unit,
+        interleaveBitAngleModule.getMicrosUntilNextField());
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      6,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x00,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x00));
+
+  interleaveBitAngleModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*subfields*/,
+    TestableClockInterface,
+    kScanningOptionDoubleBuffer | kScanningOptionScanPlan
+> scanPlanModule(ledMatrix, FRAMES_PER_SECOND);
+
+// The scan plan draws the same sequence as displayCurrentFieldModulated(): a
+// digit is drawn when it starts, and again only when its pattern changes.
+test(ScanningModuleTest, renderFieldNow_scanPlan) {
+  scanPlanModule.begin();
+  scanPlanModule.setPatternAt(0, 0x11);
+  scanPlanModule.setBrightnessAt(0, 0); // off
+  scanPlanModule.setPatternAt(1, 0x22);
+  scanPlanModule.setBrightnessAt(1, 2); // half
+  scanPlanModule.setPatternAt(2, 0x33);
+  scanPlanModule.setBrightnessAt(2, 4); // full
+  scanPlanModule.setPatternAt(3, 0x00);
+  scanPlanModule.setBrightnessAt(3, 3); // blank pattern
+  scanPlanModule.commit();
+  assertTrue(scanPlanModule.isCommitPending());
+
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 16; ++i) {
+    scanPlanModule.renderFieldNow();
+  }
+  assertFalse(scanPlanModule.isCommitPending());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      5,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 1, 0x00,
+      (int) EventType::kLedMatrixDraw, 2, 0x33,
+      (int) EventType::kLedMatrixDraw, 3, 0x00));
+
+  // A commit in the middle of a frame is picked up at the next frame.
+  scanPlanModule.renderFieldNow();
+  scanPlanModule.setBrightnessAt(0, 4);
+  scanPlanModule.commit();
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 15; ++i) {
+    scanPlanModule.renderFieldNow();
+  }
+  assertTrue(scanPlanModule.isCommitPending());
+  assertEqual(4, ledMatrix.mEventLog.getNumRecords());
+
+  ledMatrix.mEventLog.clear();
+  scanPlanModule.renderFieldNow();
+  assertFalse(scanPlanModule.isCommitPending());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x11));
+
+  scanPlanModule.end();
+}
+
+// The plan is built by commit(), so later writes to the patterns are not
+// rendered, and a second commit() is refused until the plan is picked up.
+test(ScanningModuleTest, commit_scanPlan) {
+  scanPlanModule.begin();
+  scanPlanModule.setPatternAt(0, 0x11);
+  scanPlanModule.setBrightnessAt(0, 4);
+  assertTrue(scanPlanModule.commit());
+  assertTrue(scanPlanModule.isCommitPending());
+
+  scanPlanModule.setPatternAt(0, 0x55);
+  assertFalse(scanPlanModule.commit());
+
+  ledMatrix.mEventLog.clear();
+  scanPlanModule.renderFieldNow();
+  assertFalse(scanPlanModule.isCommitPending());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x11));
+
+  // The back buffer can be committed again once the plan was picked up.
+  assertTrue(scanPlanModule.commit());
+  for (uint8_t i = 0; i < 15; ++i) {
+    scanPlanModule.renderFieldNow();
+  }
+  ledMatrix.mEventLog.clear();
+  scanPlanModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x55));
+
+  scanPlanModule.end();
+}
+
+// The rendered brightness is the one of the last commit picked up by the
+// renderer.
+test(ScanningModuleTest, getRenderedBrightnessAt_scanPlan) {
+  scanPlanModule.begin();
+  scanPlanModule.setPatternAt(1, 0x22);
+  scanPlanModule.setBrightnessAt(1, 3);
+  scanPlanModule.commit();
+  scanPlanModule.renderFieldNow();
+  assertEqual(3, scanPlanModule.getRenderedBrightnessAt(1));
+
+  scanPlanModule.setBrightnessAt(1, 1);
+  assertEqual(1, scanPlanModule.getBrightnessAt(1));
+  assertEqual(3, scanPlanModule.getRenderedBrightnessAt(1));
+
+  scanPlanModule.end();
+}
+
+// begin() also seeds the scan plan with the initial brightness.
+test(ScanningModuleTest, begin_seedsScanPlan) {
+  scanPlanModule.begin();
+  assertFalse(scanPlanModule.isCommitPending());
+  scanPlanModule.renderFieldNow();
+  assertEqual(2, scanPlanModule.getRenderedBrightnessAt(0));
+  scanPlanModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    kScanningOptionSkipBlank
+> skipBlankModule(ledMatrix, FRAMES_PER_SECOND);
+
+// Blank digits get no fields, and the lit digits share the whole frame. A
+// blank display is cleared once, then never drawn.
+test(ScanningModuleTest, renderFieldNow_skipBlank) {
+  skipBlankModule.begin();
+  const uint16_t period = skipBlankModule.getMicrosPerField();
+  skipBlankModule.setPatternAt(1, 0x11);
+  skipBlankModule.setPatternAt(3, 0x33);
+
+  // 2 lit digits, each on for half of the frame.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 4; ++i) {
+    skipBlankModule.renderFieldNow();
+    assertEqual(period * 2, skipBlankModule.getMicrosUntilNextField());
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      4,
+      (int) EventType::kLedMatrixDraw, 1, 0x11,
+      (int) EventType::kLedMatrixDraw, 3, 0x33,
+      (int) EventType::kLedMatrixDraw, 1, 0x11,
+      (int) EventType::kLedMatrixDraw, 3, 0x33));
+
+  // Blanking every digit clears the display at the next frame, which then
+  // lasts for a whole frame without any draw().
+  skipBlankModule.setPatternAt(1, 0x00);
+  skipBlankModule.setPatternAt(3, 0x00);
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 3; ++i) {
+    skipBlankModule.renderFieldNow();
+    assertEqual(skipBlankModule.getMicrosPerFrame(),
+        skipBlankModule.getMicrosUntilNextField());
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixClear));
+
+  // A single lit digit takes every field.
+  skipBlankModule.setPatternAt(2, 0x22);
+  ledMatrix.mEventLog.clear();
+  skipBlankModule.renderFieldNow();
+  skipBlankModule.renderFieldNow();
+  assertEqual(period * 4, skipBlankModule.getMicrosUntilNextField());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 2, 0x22,
+      (int) EventType::kLedMatrixDraw, 2, 0x22));
+
+  skipBlankModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*subfields*/,
+    TestableClockInterface,
+    kScanningOptionSkipBlank | kScanningOptionDither
+> skipBlankDitherModule(ledMatrix, FRAMES_PER_SECOND);
+
+// A digit whose dithered level is 0 in the current frame is skipped, and is
+// not counted as a lit digit.
+test(ScanningModuleTest, renderFieldNow_skipBlankDither) {
+  skipBlankDitherModule.begin();
+  const uint16_t period = skipBlankDitherModule.getMicrosPerField();
+  skipBlankDitherModule.setPatternAt(0, 0x11);
+  skipBlankDitherModule.setBrightnessAt(0, 4); // 0.5 subfields
+  skipBlankDitherModule.setPatternAt(2, 0x33);
+  skipBlankDitherModule.setBrightnessAt(2, 4 * 8); // full
+
+  // Digit 0 is at level 0 in the first frame, so digit 2 takes every field.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 4; ++i) {
+    skipBlankDitherModule.renderFieldNow();
+    assertEqual(period * 4, skipBlankDitherModule.getMicrosUntilNextField());
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 2, 0x33));
+
+  // Digit 0 is at level 1 in the second frame, so both digits are lit.
+  ledMatrix.mEventLog.clear();
+  skipBlankDitherModule.renderFieldNow();
+  assertEqual(period * 2, skipBlankDitherModule.getMicrosUntilNextField());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x11));
+
+  skipBlankDitherModule.end();
+}
+
+// Records the last element pattern drawn on each group, with up to 16 elements,
+// which is too wide for the EventLog of TestableLedMatrix.
+class WideLedMatrix : public LedMatrixBase {
+  public:
+    WideLedMatrix() : LedMatrixBase(kActiveHighPattern, kActiveHighPattern) {}
+
+    void clear() const {}
+
+    void draw(uint8_t group, uint16_t elementPattern) const {
+      mElementPatterns[group] = elementPattern;
+      mNumDraws++;
+    }
+
+    mutable uint16_t mElementPatterns[8];
+    mutable uint8_t mNumDraws;
+};
+
+WideLedMatrix wideLedMatrix;
+
+ScanningModule<
+    WideLedMatrix,
+    12 /*digits*/,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    kScanningOptionSegmentMajor
+> segmentMajorModule(wideLedMatrix, FRAMES_PER_SECOND);
+
+// Each field draws one segment across all 12 digits, so a frame has 8 fields.
+// The patterns are transposed at the start of each frame.
+test(ScanningModuleTest, renderFieldNow_segmentMajor) {
+  segmentMajorModule.begin();
+  assertEqual(8, segmentMajorModule.getFieldsPerFrame());
+  assertEqual(1000000 / (60 * 8), segmentMajorModule.getMicrosPerField());
+
+  segmentMajorModule.setPatternAt(0, 0x01);
+  segmentMajorModule.setPatternAt(9, 0x81);
+  segmentMajorModule.setPatternAt(11, 0x02);
+  wideLedMatrix.mNumDraws = 0;
+  for (uint8_t i = 0; i < 8; ++i) {
+    segmentMajorModule.renderFieldNow();
+  }
+  assertEqual(8, wideLedMatrix.mNumDraws);
+  assertEqual(0x0201, wideLedMatrix.mElementPatterns[0]);
+  assertEqual(0x0800, wideLedMatrix.mElementPatterns[1]);
+  assertEqual(0x0000, wideLedMatrix.mElementPatterns[2]);
+  assertEqual(0x0200, wideLedMatrix.mElementPatterns[7]);
+
+  // A change in the middle of a frame shows up in the next frame.
+  segmentMajorModule.renderFieldNow();
+  segmentMajorModule.setPatternAt(9, 0x00);
+  segmentMajorModule.setPatternAt(3, 0x80);
+  for (uint8_t i = 0; i < 7; ++i) {
+    segmentMajorModule.renderFieldNow();
+  }
+  assertEqual(0x0200, wideLedMatrix.mElementPatterns[7]);
+  segmentMajorModule.renderFieldNow();
+  assertEqual(0x0001, wideLedMatrix.mElementPatterns[0]);
+  for (uint8_t i = 0; i < 7; ++i) {
+    segmentMajorModule.renderFieldNow();
+  }
+  assertEqual(0x0800, wideLedMatrix.mElementPatterns[1]);
+  assertEqual(0x0008, wideLedMatrix.mElementPatterns[7]);
+
+  segmentMajorModule.end();
+}
+
+ScanningModule<
+    WideLedMatrix,
+    NUM_DIGITS,
+    1 /*subFields*/,
+    TestableClockInterface,
+    0 /*options*/,
+    void,
+    NoTimingProbe,
+    NoTimerInterface,
+    uint16_t
+> wideModule(wideLedMatrix, FRAMES_PER_SECOND);
+
+// 16-bit patterns, e.g. of 14-segment digits, are drawn unchanged.
+test(ScanningModuleTest, renderFieldNow_widePattern) {
+  wideModule.begin();
+  wideModule.setPatternAt(0, 0x4321);
+  wideModule.setPatternAt(3, 0xC00F);
+  assertEqual(0x4321, wideModule.getPatternAt(0));
+
+  for (uint8_t i = 0; i < NUM_DIGITS; ++i) {
+    wideModule.renderFieldNow();
+  }
+  assertEqual(0x4321, wideLedMatrix.mElementPatterns[0]);
+  assertEqual(0x0000, wideLedMatrix.mElementPatterns[1]);
+  assertEqual(0xC00F, wideLedMatrix.mElementPatterns[3]);
+
+  wideModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    kScanningOptionLateStats
+> skippingModule(ledMatrix, FRAMES_PER_SECOND);
+
+// Late polls do not push back the schedule. A poll which misses more than one
+// field skips the missed fields.
+test(ScanningModuleTest, renderFieldWhenReady_skip) {
+  TestableClockInterface::setMicros(1000);
+  skippingModule.begin();
+  const uint16_t period = skippingModule.getMicrosPerField();
+  assertEqual(1000000 / (60 * 4), period);
+
+  assertTrue(skippingModule.renderFieldWhenReady());
+  TestableClockInterface::setMicros(1000 + period - 1);
+  assertFalse(skippingModule.renderFieldWhenReady());
+
+  // 100 micros late. The next deadline is still 1000 + 2 * period.
+  TestableClockInterface::setMicros(1000 + period + 100);
+  assertTrue(skippingModule.renderFieldWhenReady());
+  TestableClockInterface::setMicros(1000 + 2 * period - 1);
+  assertFalse(skippingModule.renderFieldWhenReady());
+  TestableClockInterface::setMicros(1000 + 2 * period);
+  assertTrue(skippingModule.renderFieldWhenReady());
+  assertEqual(0, skippingModule.getNumLateFields());
+  assertEqual(100, skippingModule.getMaxLateMicros());
+
+  // 2.5 periods late. The missed fields are skipped, and the schedule
+  // restarts from the late poll.
+  uint32_t now = 1000 + 5 * period + period / 2;
+  TestableClockInterface::setMicros(now);
+  assertTrue(skippingModule.renderFieldWhenReady());
+  assertFalse(skippingModule.renderFieldWhenReady());
+  TestableClockInterface::setMicros(now + period);
+  assertTrue(skippingModule.renderFieldWhenReady());
+  assertEqual(1, skippingModule.getNumLateFields());
+  assertEqual(2 * period + period / 2, skippingModule.getMaxLateMicros());
+
+  skippingModule.clearLateStats();
+  assertEqual(0, skippingModule.getNumLateFields());
+  assertEqual(0, skippingModule.getMaxLateMicros());
+
+  skippingModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    kScanningOptionCatchUpBurst
+> burstingModule(ledMatrix, FRAMES_PER_SECOND);
+
+// With kScanningOptionCatchUpBurst, the missed fields are rendered on the
+// following polls, until the schedule has caught up.
+test(ScanningModuleTest, renderFieldWhenReady_burst) {
+  TestableClockInterface::setMicros(1000);
+  burstingModule.begin();
+  const uint16_t period = burstingModule.getMicrosPerField();
+  assertTrue(burstingModule.renderFieldWhenReady());
+
+  // Deadlines at 1 to 3 periods have passed.
+  TestableClockInterface::setMicros(1000 + 3 * period + period / 2);
+  assertTrue(burstingModule.renderFieldWhenReady());
+  assertTrue(burstingModule.renderFieldWhenReady());
+  assertTrue(burstingModule.renderFieldWhenReady());
+  assertFalse(burstingModule.renderFieldWhenReady());
+  TestableClockInterface::setMicros(1000 + 4 * period);
+  assertTrue(burstingModule.renderFieldWhenReady());
+
+  // A backlog of more than one frame (4 fields) is skipped.
+  TestableClockInterface::setMicros(1000 + 11 * period);
+  assertTrue(burstingModule.renderFieldWhenReady());
+  assertFalse(burstingModule.renderFieldWhenReady());
+
+  // Without kScanningOptionLateStats, no statistics are kept.
+  assertEqual(0, burstingModule.getNumLateFields());
+
+  burstingModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    3 /*bits*/,
+    TestableClockInterface,
+    kScanningOptionBitAngle,
+    void,
+    NoTimingProbe,
+    TestableTimerInterface
+> timerModule(ledMatrix, FRAMES_PER_SECOND);
+
+// The timer interrupt renders each bit angle subfield, and re-arms the timer
+// with its duration of 1, 2 and 4 units.
+test(ScanningModuleTest, startTimer) {
+  TestableClockInterface::setMicros(1000);
+  TestableTimerInterface::setLatencyMicros(0);
+  timerModule.begin();
+  const uint16_t unit = timerModule.getMicrosPerField();
+  timerModule.setBrightness(7);
+  timerModule.setPatternAt(1, 0x11);
+  timerModule.startTimer();
+  assertTrue(TestableTimerInterface::isAttached());
+  ledMatrix.mEventLog.clear();
+
+  // The first field is rendered after one unit.
+  TestableTimerInterface::advanceMicros(unit - 1);
+  assertEqual(0, TestableTimerInterface::sNumInterrupts);
+  TestableTimerInterface::advanceMicros(1);
+  assertEqual(1, TestableTimerInterface::sNumInterrupts);
+  assertEqual(unit, TestableTimerInterface::sPeriodMicros);
+
+  // Subfield 1 of digit 0 stays on for 2 units, subfield 2 for 4 units.
+  TestableTimerInterface::advanceMicros(unit);
+  assertEqual(2, TestableTimerInterface::sNumInterrupts);
+  assertEqual(2 * unit, TestableTimerInterface::sPeriodMicros);
+  TestableTimerInterface::advanceMicros(2 * unit - 1);
+  assertEqual(2, TestableTimerInterface::sNumInterrupts);
+  TestableTimerInterface::advanceMicros(1);
+  assertEqual(3, TestableTimerInterface::sNumInterrupts);
+  assertEqual(4 * unit, TestableTimerInterface::sPeriodMicros);
+  TestableTimerInterface::advanceMicros(4 * unit);
+  assertEqual(4, TestableTimerInterface::sNumInterrupts);
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x11));
+
+  // A frame of 4 digits * 7 units has 12 fields, regardless of the latency of
+  // the interrupt, which does not delay the following interrupts.
+  TestableTimerInterface::setLatencyMicros(unit / 2);
+  TestableTimerInterface::advanceMicros(4 * 7 * unit);
+  assertEqual(16, TestableTimerInterface::sNumInterrupts);
+  assertEqual(1000 + 8 * unit + 4 * 7 * unit,
+      TestableClockInterface::micros());
+
+  timerModule.stopTimer();
+  assertFalse(TestableTimerInterface::isAttached());
+  TestableTimerInterface::advanceMicros(4 * 7 * unit);
+  assertEqual(16, TestableTimerInterface::sNumInterrupts);
+
+  timerModule.end();
+}
+
+// Without subfields, there is no brightness control, and every digit is fully
+// on.
+test(ScanningModuleTest, getBrightnessAt_noSubFields) {
+  scanningModule.begin();
+  scanningModule.setBrightnessAt(0, 0);
+  assertEqual(1, scanningModule.getBrightnessAt(0));
+  scanningModule.end();
+}
+
+// A subclass which owns its LedMatrix, the way DirectModule and the other
+// modules do, and passes itself as T_DERIVED.
+class OwningModule : public ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    0,
+    OwningModule
+> {
+  private:
+    using Super = ScanningModule<
+        TestableLedMatrix,
+        NUM_DIGITS,
+        NUM_SUB_FIELDS,
+        TestableClockInterface,
+        0,
+        OwningModule
+    >;
+
+  public:
+    explicit OwningModule(uint8_t framesPerSecond) :
+        Super(framesPerSecond)
+    {}
+
+    TestableLedMatrix mLedMatrix;
+};
+
+OwningModule owningModule(FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, renderFieldNow_derivedLedMatrix) {
+  owningModule.begin();
+  owningModule.setPatternAt(0, 0x10);
+  owningModule.setPatternAt(1, 0x21);
+
+  owningModule.mLedMatrix.mEventLog.clear();
+  ledMatrix.mEventLog.clear();
+  owningModule.renderFieldNow();
+  owningModule.renderFieldNow();
+  assertTrue(owningModule.mLedMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x10,
+      (int) EventType::kLedMatrixDraw, 1, 0x21));
+
+  // The shared ledMatrix of the other modules is untouched.
+  assertEqual(0, ledMatrix.mEventLog.getNumRecords());
+
+  owningModule.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
@@ -0,0 +1,164 @@
+#line 2 "TimingProbeTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2022 Brian T. Park
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+#include <ace_segment/testing/TestableTmi1637Interface.h>
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+//----------------------------------------------------------------------------
+
+using Probe = TimingProbe<3, TestableClockInterface>;
+
+// Simulate a call to an instrumented method which takes `micros`.
+static void timeCall(Probe& probe, uint16_t micros) {
+  uint16_t startMicros = probe.startTiming();
+  TestableClockInterface::setMicros(TestableClockInterface::micros() + micros);
+  probe.stopTiming(startMicros);
+}
+
+test(TimingProbeTest, getStats) {
+  Probe probe;
+  TestableClockInterface::setMicros(1000);
+
+  TimingProbeStats stats = probe.getStats();
+  assertEqual(0, stats.numCalls);
+  assertEqual(0, stats.minMicros);
+  assertEqual(0, stats.avgMicros);
+
+  probe.setBudgetMicros(25);
+  timeCall(probe, 10);
+  timeCall(probe, 30);
+  timeCall(probe, 20);
+  timeCall(probe, 40);
+
+  stats = probe.getStats();
+  assertEqual(4, stats.numCalls);
+  assertEqual(2, stats.numOverruns);
+  assertEqual(10, stats.minMicros);
+  assertEqual(40, stats.maxMicros);
+  assertEqual(25, stats.avgMicros);
+
+  // The last 3 durations, most recent first.
+  assertEqual(40, probe.getRecentMicros(0));
+  assertEqual(20, probe.getRecentMicros(1));
+  assertEqual(30, probe.getRecentMicros(2));
+  assertEqual(0, probe.getRecentMicros(3));
+
+  // The budget survives resetTiming().
+  probe.resetTiming();
+  assertEqual(0, probe.getStats().numCalls);
+  assertEqual(0, probe.getRecentMicros(0));
+  assertEqual(25, probe.getBudgetMicros());
+}
+
+// The average keeps following the durations long after 65535 calls.
+test(TimingProbeTest, getStats_manyCalls) {
+  Probe probe;
+  TestableClockInterface::setMicros(1000);
+  for (uint32_t i = 0; i < 70000; ++i) {
+    timeCall(probe, 10);
+  }
+  TimingProbeStats stats = probe.getStats();
+  assertEqual((uint32_t) 70000, stats.numCalls);
+  assertEqual(10, stats.avgMicros);
+
+  for (uint16_t i = 0; i < 8 * Probe::kAverageWindow; ++i) {
+    timeCall(probe, 30);
+  }
+  stats = probe.getStats();
+  assertEqual((uint32_t) 70000 + 8 * Probe::kAverageWindow, stats.numCalls);
+  assertEqual(30, stats.avgMicros);
+  assertEqual(10, stats.minMicros);
+}
+
+test(TimingProbeTest, stopTiming_acrossRollover) {
+  Probe probe;
+  TestableClockInterface::setMicros(0xFFFFFFF0);
+  timeCall(probe, 0x20);
+  assertEqual(0x20, probe.getStats().maxMicros);
+}
+
+//----------------------------------------------------------------------------
+
+// An LedMatrix whose draw() takes 7 micros of the TestableClockInterface.
+class SlowLedMatrix {
+  public:
+    void clear() const {}
+
+    void draw(uint8_t /*group*/, uint8_t /*elementPattern*/) const {
+      TestableClockInterface::setMicros(TestableClockInterface::micros() + 7);
+    }
+};
+
+SlowLedMatrix slowLedMatrix;
+
+ScanningModule<
+    SlowLedMatrix,
+    4 /*digits*/,
+    1 /*subfields*/,
+    TestableClockInterface,
+    0 /*options*/,
+    void /*derived*/,
+    Probe
+> probedModule(slowLedMatrix, 60 /*framesPerSecond*/);
+
+test(TimingProbeTest, renderFieldNow) {
+  probedModule.begin();
+  assertEqual(probedModule.getMicrosPerField(),
+      probedModule.getTimingProbe().getBudgetMicros());
+
+  for (uint8_t i = 0; i < 5; ++i) {
+    probedModule.renderFieldNow();
+  }
+  TimingProbeStats stats = probedModule.getTimingProbe().getStats();
+  assertEqual(5, stats.numCalls);
+  assertEqual(7, stats.minMicros);
+  assertEqual(7, stats.maxMicros);
+  assertEqual(0, stats.numOverruns);
+
+  // A budget tighter than draw() counts every call as an overrun.
+  probedModule.getTimingProbe().setBudgetMicros(5);
+  probedModule.renderFieldNow();
+  assertEqual(1, probedModule.getTimingProbe().getStats().numOverruns);
+
+  probedModule.end();
+}
+
+TestableTmi1637Interface tmiInterface;
+Tm1637Module<TestableTmi1637Interface, 4, false, Probe> probedTm1637Module(
+    tmiInterface);
+
+// flush(), flushIncremental() and flushDirty() share the same probe.
+test(TimingProbeTest, flush) {
+  probedTm1637Module.begin();
+  probedTm1637Module.flush();
+  probedTm1637Module.flushIncremental();
+  probedTm1637Module.flushDirty();
+  assertEqual(3, probedTm1637Module.getTimingProbe().getStats().numCalls);
+  probedTm1637Module.end();
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
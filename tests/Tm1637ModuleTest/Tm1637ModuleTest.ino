@@ -161,6 +161,134 @@ test(Tm1637ModuleTest, flush) {
   tm1637Module.end();
 }
 
+using TmModuleShadow =
+    Tm1637Module<TestableTmi1637Interface, NUM_DIGITS, true>;
+TmModuleShadow tm1637ModuleShadow(tmiInterface);
+
+test(Tm1637ModuleTest, flush_shadow) {
+  tmiInterface.begin();
+  tm1637ModuleShadow.begin();
+
+  // The first flush() sends everything because the chip state is unknown.
+  gEventLog.clear();
+  tm1637ModuleShadow.flush();
+  assertEqual(13, gEventLog.getNumRecords());
+
+  // Change digit 1 and back again. Nothing is sent.
+  tm1637ModuleShadow.setPatternAt(1, 0x11);
+  tm1637ModuleShadow.setPatternAt(1, 0x00);
+  assertTrue(tm1637ModuleShadow.isFlushRequired());
+  gEventLog.clear();
+  tm1637ModuleShadow.flush();
+  assertEqual(0, gEventLog.getNumRecords());
+  assertFalse(tm1637ModuleShadow.isFlushRequired());
+
+  // Change digits 1 and 2. Only the span [1, 2] is sent, with no brightness.
+  tm1637ModuleShadow.setPatternAt(1, 0x11);
+  tm1637ModuleShadow.setPatternAt(2, 0x22);
+  gEventLog.clear();
+  tm1637ModuleShadow.flush();
+  assertTrue(gEventLog.assertEvents(
+    8,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModuleShadow::kDataCmdAutoAddress,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModuleShadow::kAddressCmd | 1,
+    (int) EventType::kTmi1637SendByte, 0x11,
+    (int) EventType::kTmi1637SendByte, 0x22,
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  // Change only the brightness.
+  tm1637ModuleShadow.setBrightness(3);
+  gEventLog.clear();
+  tm1637ModuleShadow.flush();
+  assertTrue(gEventLog.assertEvents(
+    3,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte,
+        TmModuleShadow::kBrightnessCmd | TmModuleShadow::kBrightnessLevelOn | 3,
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  tm1637ModuleShadow.end();
+}
+
+// The first flushDirty() sends everything, so that later calls can skip the
+// digits which the chip already holds.
+test(Tm1637ModuleTest, flushDirty_shadow) {
+  tmiInterface.begin();
+  tm1637ModuleShadow.begin();
+  gEventLog.clear();
+  tm1637ModuleShadow.flushDirty();
+  assertEqual(13, gEventLog.getNumRecords());
+
+  // Change digit 1 and back again. Nothing is sent.
+  tm1637ModuleShadow.setPatternAt(1, 0x11);
+  tm1637ModuleShadow.setPatternAt(1, 0x00);
+  gEventLog.clear();
+  tm1637ModuleShadow.flushDirty();
+  assertEqual(0, gEventLog.getNumRecords());
+  assertFalse(tm1637ModuleShadow.isFlushRequired());
+
+  // Change digit 2. Only digit 2 is sent.
+  tm1637ModuleShadow.setPatternAt(2, 0x22);
+  gEventLog.clear();
+  tm1637ModuleShadow.flushDirty();
+  assertTrue(gEventLog.assertEvents(
+    7,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModuleShadow::kDataCmdAutoAddress,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModuleShadow::kAddressCmd | 2,
+    (int) EventType::kTmi1637SendByte, 0x22,
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  tm1637ModuleShadow.end();
+}
+
+test(Tm1637ModuleTest, flushDirty) {
+  tmiInterface.begin();
+  tm1637Module.begin();
+  tm1637Module.flush();
+
+  // Two runs: digit 0, and digits 2-3, followed by the brightness.
+  tm1637Module.setPatternAt(0, 0x01);
+  tm1637Module.setPatternAt(2, 0x23);
+  tm1637Module.setPatternAt(3, 0x34);
+  tm1637Module.setBrightness(5);
+  gEventLog.clear();
+  tm1637Module.flushDirty();
+  assertTrue(gEventLog.assertEvents(
+    15,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule::kDataCmdAutoAddress,
+    (int) EventType::kTmi1637StopCondition,
+
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule::kAddressCmd | 0,
+    (int) EventType::kTmi1637SendByte, 0x01,
+    (int) EventType::kTmi1637StopCondition,
+
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule::kAddressCmd | 2,
+    (int) EventType::kTmi1637SendByte, 0x23,
+    (int) EventType::kTmi1637SendByte, 0x34,
+    (int) EventType::kTmi1637StopCondition,
+
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte,
+        TmModule::kBrightnessCmd | TmModule::kBrightnessLevelOn | 5,
+    (int) EventType::kTmi1637StopCondition
+  ));
+  assertFalse(tm1637Module.isFlushRequired());
+
+  tm1637Module.end();
+}
+
 test(Tm1637ModuleTest, isFlushRequired) {
   tm1637Module.begin();
   assertTrue(tm1637Module.isFlushRequired());
@@ -168,12 +296,16 @@ test(Tm1637ModuleTest, isFlushRequired) {
   tm1637Module.flush();
   assertFalse(tm1637Module.isFlushRequired());
 
-  tm1637Module.setPatternAt(0, 0);
+  tm1637Module.setPatternAt(0, 0x5A);
   assertTrue(tm1637Module.isFlushRequired());
 
   tm1637Module.flush();
   assertFalse(tm1637Module.isFlushRequired());
 
+  // Writing an unchanged pattern does not require a flush.
+  tm1637Module.setPatternAt(0, 0x5A);
+  assertFalse(tm1637Module.isFlushRequired());
+
   tm1637Module.setBrightness(1);
   assertTrue(tm1637Module.isFlushRequired());
 
@@ -96,6 +96,47 @@ test(Tm1638ModuleTest, flush) {
   tm1638Module.end();
 }
 
+test(Tm1638ModuleTest, flushDirty) {
+  tmiInterface.begin();
+  tm1638Module.begin();
+  tm1638Module.flush();
+
+  // Two runs: digit 1, and digits 5-6. Brightness is not dirty.
+  tm1638Module.setPatternAt(1, 0x12);
+  tm1638Module.setPatternAt(5, 0x56);
+  tm1638Module.setPatternAt(6, 0x67);
+  gEventLog.clear();
+  tm1638Module.flushDirty();
+  assertTrue(gEventLog.assertEvents(
+    15,
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kDataCmdAutoAddress,
+    (int) EventType::kTmi1638EndTransaction,
+
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kAddressCmd | 2,
+    (int) EventType::kTmi1638Write, 0x12,
+    (int) EventType::kTmi1638Write, 0x00,
+    (int) EventType::kTmi1638EndTransaction,
+
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kAddressCmd | 10,
+    (int) EventType::kTmi1638Write, 0x56,
+    (int) EventType::kTmi1638Write, 0x00,
+    (int) EventType::kTmi1638Write, 0x67,
+    (int) EventType::kTmi1638Write, 0x00,
+    (int) EventType::kTmi1638EndTransaction
+  ));
+  assertFalse(tm1638Module.isFlushRequired());
+
+  // Nothing dirty, nothing sent.
+  gEventLog.clear();
+  tm1638Module.flushDirty();
+  assertEqual(0, gEventLog.getNumRecords());
+
+  tm1638Module.end();
+}
+
 test(Tm1638ModuleTest, isFlushRequired) {
   tm1638Module.begin();
   assertTrue(tm1638Module.isFlushRequired());
@@ -103,12 +144,16 @@ test(Tm1638ModuleTest, isFlushRequired) {
   tm1638Module.flush();
   assertFalse(tm1638Module.isFlushRequired());
 
-  tm1638Module.setPatternAt(0, 0);
+  tm1638Module.setPatternAt(0, 0x5A);
   assertTrue(tm1638Module.isFlushRequired());
 
   tm1638Module.flush();
   assertFalse(tm1638Module.isFlushRequired());
 
+  // Writing an unchanged pattern does not require a flush.
+  tm1638Module.setPatternAt(0, 0x5A);
+  assertFalse(tm1638Module.isFlushRequired());
+
   tm1638Module.setBrightness(0);
   assertTrue(tm1638Module.isFlushRequired());
 